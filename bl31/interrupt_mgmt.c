@@ -30,7 +30,9 @@
 
 #include <assert.h>
 #include <bl_common.h>
+#include <cassert.h>
 #include <context_mgmt.h>
+#include <debug.h>
 #include <errno.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
@@ -66,6 +68,36 @@ typedef struct intr_type_desc {
 
 static intr_type_desc_t intr_type_descs[MAX_INTR_TYPES];
 
+#if EL3_INTR_ID_DISPATCH
+/*******************************************************************************
+ * Local structure and corresponding array, indexed by interrupt ID, to keep
+ * track of the handlers registered for individual interrupts. The array is
+ * looked up by the interrupt exception vectors in runtime_exceptions.S.
+ * The field descriptions are:
+ *
+ * 'handler' : Handler for the interrupt ID, or NULL.
+ *
+ * 'flags'   : Bit[0], '1' implies that the handler is called without saving
+ *                     the callee saved registers and the EL3 state of the
+ *                     interrupted context (INTR_ID_FLAG_FAST).
+ *
+ *             All other bits are reserved and SBZ.
+ ******************************************************************************/
+typedef struct intr_id_desc {
+	interrupt_type_handler_t handler;
+	uint32_t flags;
+} intr_id_desc_t;
+
+intr_id_desc_t intr_id_descs[PLAT_EL3_INTR_ID_LIMIT];
+
+CASSERT(sizeof(intr_id_desc_t) == (1 << INTR_ID_DESC_SIZE_LOG2), \
+	assert_intr_id_desc_size_mismatch);
+CASSERT(INTR_ID_DESC_HANDLER == __builtin_offsetof(intr_id_desc_t, handler), \
+	assert_intr_id_desc_handler_offset_mismatch);
+CASSERT(INTR_ID_DESC_FLAGS == __builtin_offsetof(intr_id_desc_t, flags), \
+	assert_intr_id_desc_flags_offset_mismatch);
+#endif
+
 /*******************************************************************************
  * This function validates the interrupt type.
  ******************************************************************************/
@@ -248,3 +280,84 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	return intr_type_descs[type].handler;
 }
 
+#if EL3_INTR_ID_DISPATCH
+/*******************************************************************************
+ * This function registers a handler for the interrupt 'id'. When the interrupt
+ * is pending at EL3, the interrupt exception vectors acknowledge it, call the
+ * handler and then signal the end of interrupt, without involving the handler
+ * of its type. The end of an SGI is signalled before its handler is called.
+ * The interrupt must be a Group 0 one and the routing model of its type must
+ * route it to EL3, see set_routing_model().
+ *
+ * If INTR_ID_FLAG_FAST is set in 'flags', the handler is called as soon as the
+ * registers that the C runtime may corrupt have been saved, and execution
+ * resumes in the interrupted context right after it returns. Such a handler
+ * must not unmask interrupts, change the context of either security state or
+ * return to a different one. Otherwise, the handler is called once the full
+ * context has been saved and may do so.
+ ******************************************************************************/
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags)
+{
+	/* Validate the 'id' and 'handler' parameters */
+	if (id >= PLAT_EL3_INTR_ID_LIMIT || !handler)
+		return -EINVAL;
+
+	/* Validate the 'flags' parameter */
+	if (flags & INTR_ID_FLAGS_MASK)
+		return -EINVAL;
+
+	/* Only Group 0 interrupts are acknowledged at EL3 */
+	assert(plat_ic_get_interrupt_type(id) == PLAT_EL3_INTR_ID_TYPE);
+
+	/* Check if a handler has already been registered */
+	if (intr_id_descs[id].handler)
+		return -EALREADY;
+
+	intr_id_descs[id].flags = flags;
+	intr_id_descs[id].handler = handler;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function returns the handler registered for the interrupt 'id', or NULL
+ * if there is none.
+ ******************************************************************************/
+interrupt_type_handler_t get_interrupt_handler(uint32_t id)
+{
+	if (id >= PLAT_EL3_INTR_ID_LIMIT)
+		return NULL;
+
+	return intr_id_descs[id].handler;
+}
+
+/*******************************************************************************
+ * This function is called by the interrupt exception vectors for an interrupt
+ * that they have acknowledged but which has no handler of its own. This
+ * happens when another interrupt became the highest priority pending one
+ * before the acknowledge. The interrupt is passed to the handler of its type,
+ * with the raw value returned by plat_ic_acknowledge_interrupt() as 'id'. That
+ * handler must not acknowledge it again, and must signal its end of interrupt.
+ ******************************************************************************/
+uint64_t dispatch_acked_interrupt(uint32_t id,
+				  uint32_t flags,
+				  void *handle,
+				  void *cookie)
+{
+	interrupt_type_handler_t handler;
+	uint32_t type;
+
+	type = plat_ic_get_interrupt_type(id & INTR_ID_RAW_MASK);
+	handler = get_interrupt_type_handler(type);
+	if (!handler) {
+		ERROR("No handler for interrupt %u of type %u\n",
+		      id & INTR_ID_RAW_MASK, type);
+		plat_ic_end_of_interrupt(id);
+		return 0;
+	}
+
+	return handler(id, flags, handle, cookie);
+}
+#endif
@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <io_storage.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <string.h>
 #include <utils.h>
 #include <xlat_tables.h>
@@ -178,6 +179,129 @@ static void dump_load_info(uintptr_t image_load_addr,
 }
 #endif /* LOAD_IMAGE_V2 */
 
+/*
+ * Size of the chunks an image is read in when the IO backend supports
+ * asynchronous reads or the image is hashed while it is loaded. A platform may
+ * override it in platform_def.h.
+ */
+#ifndef PLAT_IMAGE_LOAD_CHUNK_SIZE
+#define PLAT_IMAGE_LOAD_CHUNK_SIZE	0x10000
+#endif
+
+/* Non-zero while the image being loaded is hashed incrementally */
+static int image_hash_streamed;
+
+/*******************************************************************************
+ * Post-process a chunk of an image that has been read into memory, while it is
+ * still in the cache. When the image is read asynchronously, this runs while
+ * the read of the next chunk is in flight, so the cache line shared with the
+ * next chunk is left alone until the last chunk.
+ ******************************************************************************/
+static void image_chunk_loaded(uintptr_t image_base, uintptr_t chunk_base,
+			       size_t chunk_size, int last)
+{
+#if TRUSTED_BOARD_BOOT
+	/* Feed the image hash if it is being computed incrementally */
+	auth_mod_hash_img_update((void *)chunk_base, chunk_size);
+#else
+	uintptr_t start, end;
+
+	/*
+	 * Flush the image to main memory so that it can be executed later by
+	 * any CPU, regardless of cache and MMU state.
+	 * When TBB is enabled the image is flushed later, after image
+	 * authentication.
+	 */
+	start = (chunk_base == image_base) ? image_base :
+		round_down(chunk_base, CACHE_WRITEBACK_GRANULE);
+	end = chunk_base + chunk_size;
+	if (!last)
+		end = round_down(end, CACHE_WRITEBACK_GRANULE);
+	if (end > start)
+		flush_dcache_range(start, end - start);
+#endif /* TRUSTED_BOARD_BOOT */
+}
+
+/*******************************************************************************
+ * Read an image into memory. If the IO backend supports asynchronous reads, the
+ * image is read in chunks and the read of the next chunk is started before the
+ * current one is post-processed. Otherwise the image is read with a single
+ * io_read(), unless it is hashed while it is loaded, in which case each chunk
+ * is hashed as soon as it has been read, while it is still in the cache.
+ *
+ * Returns 0 on success, a negative error code otherwise. The number of bytes
+ * actually read is returned in 'bytes_read'.
+ ******************************************************************************/
+static int read_image(uintptr_t image_handle, uintptr_t image_base,
+		      size_t image_size, size_t *bytes_read)
+{
+	uintptr_t chunk_base = image_base;
+	size_t chunk_size, next_size, len;
+	int rc;
+
+	chunk_size = image_size;
+	if (chunk_size > PLAT_IMAGE_LOAD_CHUNK_SIZE)
+		chunk_size = PLAT_IMAGE_LOAD_CHUNK_SIZE;
+
+	*bytes_read = 0;
+	rc = io_read_start(image_handle, chunk_base, chunk_size);
+	if ((rc == -ENODEV) && !image_hash_streamed) {
+		/* Synchronous backend, nothing to do between the chunks */
+		rc = io_read(image_handle, image_base, image_size, bytes_read);
+		if ((rc == 0) && (*bytes_read == image_size))
+			image_chunk_loaded(image_base, image_base, image_size, 1);
+		return rc;
+	} else if (rc == -ENODEV) {
+		/* Synchronous backend */
+		do {
+			rc = io_read(image_handle, chunk_base, chunk_size,
+				     &len);
+			if (rc != 0)
+				break;
+			*bytes_read += len;
+			if (len < chunk_size)
+				break;
+
+			image_chunk_loaded(image_base, chunk_base, chunk_size,
+					   *bytes_read == image_size);
+
+			chunk_base += chunk_size;
+			chunk_size = image_size - *bytes_read;
+			if (chunk_size > PLAT_IMAGE_LOAD_CHUNK_SIZE)
+				chunk_size = PLAT_IMAGE_LOAD_CHUNK_SIZE;
+		} while (chunk_size != 0);
+
+		return rc;
+	}
+
+	while (rc == 0) {
+		rc = io_read_wait(image_handle, &len);
+		if (rc != 0)
+			break;
+		*bytes_read += len;
+		if (len < chunk_size)
+			break;
+
+		/* Queue the next chunk before processing the current one */
+		next_size = image_size - *bytes_read;
+		if (next_size > PLAT_IMAGE_LOAD_CHUNK_SIZE)
+			next_size = PLAT_IMAGE_LOAD_CHUNK_SIZE;
+		if (next_size != 0)
+			rc = io_read_start(image_handle,
+					   chunk_base + chunk_size, next_size);
+
+		image_chunk_loaded(image_base, chunk_base, chunk_size,
+				   next_size == 0);
+
+		if (next_size == 0)
+			break;
+		chunk_base += chunk_size;
+		chunk_size = next_size;
+	}
+
+	return rc;
+}
+
 /* Generic function to return the size of an image */
 size_t image_size(unsigned int image_id)
 {
@@ -212,11 +336,10 @@ size_t image_size(unsigned int image_id)
 	io_result = io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this
-	 * bootloader stage
+	/*
+	 * The device connection is kept open for the rest of this bootloader
+	 * stage, so that a FIP is only indexed once.
 	 */
-	io_result = io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
 
 	return image_size;
 }
@@ -284,23 +407,13 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	io_result = read_image(image_handle, image_base, image_size,
+			       &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
 
-#if !TRUSTED_BOARD_BOOT
-	/*
-	 * File has been successfully loaded.
-	 * Flush the image to main memory so that it can be executed later by
-	 * any CPU, regardless of cache and MMU state.
-	 * When TBB is enabled the image is flushed later, after image
-	 * authentication.
-	 */
-	flush_dcache_range(image_base, image_size);
-#endif /* TRUSTED_BOARD_BOOT */
-
 	INFO("Image id=%u loaded: %p - %p\n", image_id, (void *) image_base,
 	     (void *) (image_base + image_size));
 
@@ -308,9 +421,7 @@ exit:
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
+	/* The device connection is kept open for this bootloader stage */
 
 	return io_result;
 }
@@ -337,10 +448,14 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 			return rc;
 		}
 	}
+
+	/* Hash the image while it is loaded if possible */
+	image_hash_streamed = (auth_mod_hash_img_start(image_id) == 0);
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
 	rc = load_image(image_id, image_data);
+	image_hash_streamed = 0;
 	if (rc != 0) {
 		return rc;
 	}
@@ -444,7 +559,8 @@ int load_image(meminfo_t *mem_layout,
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	io_result = read_image(image_handle, image_base, image_size,
+			       &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -469,17 +585,6 @@ int load_image(meminfo_t *mem_layout,
 		     (void *) image_base, image_size);
 	}
 
-#if !TRUSTED_BOARD_BOOT
-	/*
-	 * File has been successfully loaded.
-	 * Flush the image to main memory so that it can be executed later by
-	 * any CPU, regardless of cache and MMU state.
-	 * When TBB is enabled the image is flushed later, after image
-	 * authentication.
-	 */
-	flush_dcache_range(image_base, image_size);
-#endif /* TRUSTED_BOARD_BOOT */
-
 	INFO("Image id=%u loaded at address %p, size = 0x%zx\n", image_id,
 		(void *) image_base, image_size);
 
@@ -487,9 +592,7 @@ exit:
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
+	/* The device connection is kept open for this bootloader stage */
 
 	return io_result;
 }
@@ -521,11 +624,15 @@ int load_auth_image(meminfo_t *mem_layout,
 			return rc;
 		}
 	}
+
+	/* Hash the image while it is loaded if possible */
+	image_hash_streamed = (auth_mod_hash_img_start(image_id) == 0);
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
 	rc = load_image(mem_layout, image_id, image_base, image_data,
 			entry_point_info);
+	image_hash_streamed = 0;
 	if (rc != 0) {
 		return rc;
 	}
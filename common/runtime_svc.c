@@ -28,9 +28,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
+#include <cpu_data.h>
 #include <debug.h>
 #include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
 #include <runtime_svc.h>
 #include <string.h>
 
@@ -51,6 +56,100 @@ static rt_svc_desc_t *rt_svc_descs;
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+/*******************************************************************************
+ * The 'rt_svc_fid_table' is an open addressed hash table built from the
+ * per function id descriptors exported in the 'rt_svc_fid_descs' linker
+ * section. It is probed by the SMC entry path before falling back to the
+ * owning entity lookup, so that a registered function id reaches its handler
+ * through a single indirect branch.
+ ******************************************************************************/
+#define RT_SVC_FID_DESCS_START	((uintptr_t) (&__RT_SVC_FID_DESCS_START__))
+#define RT_SVC_FID_DESCS_END	((uintptr_t) (&__RT_SVC_FID_DESCS_END__))
+rt_svc_fid_entry_t rt_svc_fid_table[RT_SVC_FID_TABLE_SIZE];
+
+#if RT_SVC_FID_STATS
+typedef struct rt_svc_cpu_fid_stats {
+	rt_svc_fid_stats_t fid[RT_SVC_FID_TABLE_SIZE];
+} __per_cpu_aligned rt_svc_cpu_fid_stats_t;
+
+static DEFINE_PER_CPU_ARRAY(rt_svc_cpu_fid_stats_t, rt_svc_fid_stats);
+#endif
+
+/*******************************************************************************
+ * Return the index of the slot holding `smc_fid` in the per function id
+ * dispatch table, or -1 if no handler is registered for it.
+ ******************************************************************************/
+int rt_svc_fid_lookup(uint32_t smc_fid)
+{
+	unsigned int idx = RT_SVC_FID_HASH(smc_fid);
+
+	while (rt_svc_fid_table[idx].fid != RT_SVC_FID_INVALID) {
+		if (rt_svc_fid_table[idx].fid == smc_fid)
+			return idx;
+		idx = (idx + 1) & (RT_SVC_FID_TABLE_SIZE - 1);
+	}
+
+	return -1;
+}
+
+#if RT_SVC_FID_STATS
+/*******************************************************************************
+ * Account `ticks` spent in the handler installed in slot `index` of the
+ * per function id dispatch table to the calling cpu.
+ ******************************************************************************/
+static void rt_svc_fid_stats_update(unsigned int index, uint64_t ticks)
+{
+	rt_svc_fid_stats_t *stats;
+
+	if (index >= RT_SVC_FID_TABLE_SIZE)
+		return;
+
+	stats = &rt_svc_fid_stats[plat_my_core_pos()].fid[index];
+	stats->count++;
+	stats->total_ticks += ticks;
+	if (ticks > stats->max_ticks)
+		stats->max_ticks = ticks;
+}
+
+/*******************************************************************************
+ * Copy the statistics collected on cpu `cpu_idx` for `smc_fid` into `stats`.
+ * Returns -ENOENT if no per function id handler is registered for `smc_fid`.
+ ******************************************************************************/
+int rt_svc_fid_get_stats(uint32_t smc_fid, unsigned int cpu_idx,
+			 rt_svc_fid_stats_t *stats)
+{
+	int idx;
+
+	assert(stats);
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+
+	idx = rt_svc_fid_lookup(smc_fid);
+	if (idx < 0)
+		return -ENOENT;
+
+	*stats = rt_svc_fid_stats[cpu_idx].fid[idx];
+	return 0;
+}
+#endif /* RT_SVC_FID_STATS */
+
+#if RT_SVC_ACCOUNTING
+/*******************************************************************************
+ * Account `ticks` spent handling `smc_fid` on the calling cpu. `index` is the
+ * slot of the per function id dispatch table through which the SMC was
+ * dispatched, or RT_SVC_FID_INVALID. Called once the handler has returned,
+ * which does not happen for calls that power down the cpu.
+ ******************************************************************************/
+void rt_svc_account(uint32_t smc_fid, unsigned int index, uint64_t ticks)
+{
+#if RT_SVC_FID_STATS
+	rt_svc_fid_stats_update(index, ticks);
+#endif
+#if ENABLE_SMC_HIST
+	pmf_smc_hist_update(smc_fid, index, ticks);
+#endif
+}
+#endif /* RT_SVC_ACCOUNTING */
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid.
  ******************************************************************************/
@@ -62,21 +161,43 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	u_register_t x1, x2, x3, x4;
 	int index, idx;
 	const rt_svc_desc_t *rt_svc_descs;
+	rt_svc_handle_t svc_handle = NULL;
+#if RT_SVC_ACCOUNTING
+	uint64_t start;
+	uintptr_t rc;
+#endif
 
 	assert(handle);
-	idx = get_unique_oen_from_smc_fid(smc_fid);
-	assert(idx >= 0 && idx < MAX_RT_SVCS);
 
-	index = rt_svc_descs_indices[idx];
-	if (index < 0 || index >= RT_SVC_DECS_NUM)
-		SMC_RET1(handle, SMC_UNK);
+	/* Try the per function id dispatch table first */
+	idx = rt_svc_fid_lookup(smc_fid);
+	if (idx >= 0)
+		svc_handle = rt_svc_fid_table[idx].handle;
 
-	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
+	if (svc_handle == NULL) {
+		idx = get_unique_oen_from_smc_fid(smc_fid);
+		assert(idx >= 0 && idx < MAX_RT_SVCS);
+
+		index = rt_svc_descs_indices[idx];
+		if (index < 0 || index >= RT_SVC_DECS_NUM)
+			SMC_RET1(handle, SMC_UNK);
+
+		rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
+		svc_handle = rt_svc_descs[index].handle;
+		idx = -1;
+	}
 
 	get_smc_params_from_ctx(handle, x1, x2, x3, x4);
 
-	return rt_svc_descs[index].handle(smc_fid, x1, x2, x3, x4, cookie,
-						handle, flags);
+#if RT_SVC_ACCOUNTING
+	start = read_cntpct_el0();
+	rc = svc_handle(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+	rt_svc_account(smc_fid, (idx < 0) ? RT_SVC_FID_INVALID : idx,
+		       read_cntpct_el0() - start);
+	return rc;
+#else
+	return svc_handle(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+#endif
 }
 
 /*******************************************************************************
@@ -103,6 +224,58 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+/*******************************************************************************
+ * Install the handlers exported through DECLARE_RT_SVC_FID() into the per
+ * function id dispatch table. A handler is only installed if the runtime
+ * service owning its function id was registered and initialised successfully,
+ * otherwise the call is left to the owning entity lookup which will report it
+ * as unknown.
+ ******************************************************************************/
+static void rt_svc_fid_table_init(void)
+{
+	const rt_svc_fid_desc_t *desc;
+	unsigned int num = 0, idx;
+	int oen;
+
+	assert(RT_SVC_FID_DESCS_END >= RT_SVC_FID_DESCS_START);
+
+	desc = (const rt_svc_fid_desc_t *) RT_SVC_FID_DESCS_START;
+	for (; (uintptr_t) desc < RT_SVC_FID_DESCS_END; desc++) {
+		if ((desc->handle == NULL) ||
+		    (desc->fid == RT_SVC_FID_INVALID)) {
+			ERROR("Invalid runtime service descriptor %s\n",
+				desc->name);
+			panic();
+		}
+
+		oen = get_unique_oen_from_smc_fid(desc->fid);
+		if (rt_svc_descs_indices[oen] >= MAX_RT_SVCS)
+			continue;
+
+		/* Keep at least half of the table empty */
+		if (++num > RT_SVC_FID_TABLE_SIZE / 2) {
+			ERROR("Too many runtime service function handlers\n");
+			panic();
+		}
+
+		idx = RT_SVC_FID_HASH(desc->fid);
+		while (rt_svc_fid_table[idx].fid != RT_SVC_FID_INVALID) {
+			if (rt_svc_fid_table[idx].fid == desc->fid) {
+				ERROR("Duplicate handler %s for SMC 0x%x\n",
+					desc->name, desc->fid);
+				panic();
+			}
+			idx = (idx + 1) & (RT_SVC_FID_TABLE_SIZE - 1);
+		}
+
+		rt_svc_fid_table[idx].fid = desc->fid;
+		rt_svc_fid_table[idx].handle = desc->handle;
+#if ENABLE_SMC_HIST
+		pmf_smc_hist_add_fid(idx);
+#endif
+	}
+}
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -118,13 +291,17 @@ void runtime_svc_init(void)
 	assert((RT_SVC_DESCS_END >= RT_SVC_DESCS_START) &&
 			(RT_SVC_DECS_NUM < MAX_RT_SVCS));
 
+	/* Initialise internal variables to invalid state */
+	memset(rt_svc_descs_indices, -1, sizeof(rt_svc_descs_indices));
+	for (index = 0; index < RT_SVC_FID_TABLE_SIZE; index++) {
+		rt_svc_fid_table[index].fid = RT_SVC_FID_INVALID;
+		rt_svc_fid_table[index].handle = NULL;
+	}
+
 	/* If no runtime services are implemented then simply bail out */
 	if (RT_SVC_DECS_NUM == 0)
 		return;
 
-	/* Initialise internal variables to invalid state */
-	memset(rt_svc_descs_indices, -1, sizeof(rt_svc_descs_indices));
-
 	rt_svc_descs = (rt_svc_desc_t *) RT_SVC_DESCS_START;
 	for (index = 0; index < RT_SVC_DECS_NUM; index++) {
 		rt_svc_desc_t *service = &rt_svc_descs[index];
@@ -172,4 +349,6 @@ void runtime_svc_init(void)
 		for (; start_idx <= end_idx; start_idx++)
 			rt_svc_descs_indices[start_idx] = index;
 	}
+
+	rt_svc_fid_table_init();
 }
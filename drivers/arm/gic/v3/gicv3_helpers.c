@@ -280,82 +280,113 @@ void gicv3_rdistif_base_addrs_probe(uintptr_t *rdistif_base_addrs,
 }
 
 /*******************************************************************************
- * Helper function to configure the default attributes of SPIs.
+ * Helper function to record the secure SPIs of group `int_grp` from a list in
+ * the bitmaps used by gicv3_spis_configure(). Each bitmap word covers the 32
+ * interrupt IDs of one IGROUPR/IGRPMODR register.
  ******************************************************************************/
-void gicv3_spis_configure_defaults(uintptr_t gicd_base)
+static void gicv3_spis_mark_secure(unsigned int *sec_map,
+				   unsigned int *g1s_map,
+				   unsigned int num_ints,
+				   const unsigned int *sec_intr_list,
+				   unsigned int int_grp)
 {
-	unsigned int index, num_ints;
-
-	num_ints = gicd_read_typer(gicd_base);
-	num_ints &= TYPER_IT_LINES_NO_MASK;
-	num_ints = (num_ints + 1) << 5;
+	unsigned int index, irq_num, n, bit;
 
-	/*
-	 * Treat all SPIs as G1NS by default. The number of interrupts is
-	 * calculated as 32 * (IT_LINES + 1). We do 32 at a time.
-	 */
-	for (index = MIN_SPI_ID; index < num_ints; index += 32)
-		gicd_write_igroupr(gicd_base, index, ~0U);
-
-	/* Setup the default SPI priorities doing four at a time */
-	for (index = MIN_SPI_ID; index < num_ints; index += 4)
-		gicd_write_ipriorityr(gicd_base,
-				      index,
-				      GICD_IPRIORITYR_DEF_VAL);
+	/* If `num_ints` is not 0, ensure that `sec_intr_list` is not NULL */
+	assert(num_ints ? (uintptr_t)sec_intr_list : 1);
 
-	/*
-	 * Treat all SPIs as level triggered by default, write 16 at
-	 * a time
-	 */
-	for (index = MIN_SPI_ID; index < num_ints; index += 16)
-		gicd_write_icfgr(gicd_base, index, 0);
+	for (index = 0; index < num_ints; index++) {
+		irq_num = sec_intr_list[index];
+		if (irq_num < MIN_SPI_ID)
+			continue;
+
+		assert(irq_num < GICD_MAX_INTR_ID);
+		n = irq_num >> IGROUPR_SHIFT;
+		bit = 1U << (irq_num & ((1 << IGROUPR_SHIFT) - 1));
+
+		sec_map[n] |= bit;
+		if (int_grp == INTR_GROUP1S)
+			g1s_map[n] |= bit;
+		else
+			g1s_map[n] &= ~bit;
+	}
 }
 
 /*******************************************************************************
- * Helper function to configure secure G0 and G1S SPIs.
+ * Helper function to configure the SPIs. The secure SPIs listed in
+ * `g1s_intr_list` and `g0_intr_list` are configured as G1S and G0 interrupts
+ * respectively, with the highest secure priority, targeted to the calling CPU
+ * and enabled. The other SPIs are configured as G1NS, level triggered
+ * interrupts with the default Normal world priority. An interrupt which is in
+ * both lists is configured as a G0 interrupt.
+ *
+ * The value of each group, modifier, priority and enable register is computed
+ * beforehand and written once, instead of a read-modify-write of every register
+ * for each secure interrupt.
  ******************************************************************************/
-void gicv3_secure_spis_configure(uintptr_t gicd_base,
-				     unsigned int num_ints,
-				     const unsigned int *sec_intr_list,
-				     unsigned int int_grp)
+void gicv3_spis_configure(uintptr_t gicd_base,
+			  unsigned int g1s_num_ints,
+			  const unsigned int *g1s_intr_list,
+			  unsigned int g0_num_ints,
+			  const unsigned int *g0_intr_list)
 {
-	unsigned int index, irq_num;
+	unsigned int sec_map[GICD_MAX_INTR_ID >> IGROUPR_SHIFT] = { 0 };
+	unsigned int g1s_map[GICD_MAX_INTR_ID >> IGROUPR_SHIFT] = { 0 };
+	unsigned int index, num_ints, sec, pri, prio, i, j;
 	unsigned long long gic_affinity_val;
 
-	assert((int_grp == INTR_GROUP1S) || (int_grp == INTR_GROUP0));
-	/* If `num_ints` is not 0, ensure that `sec_intr_list` is not NULL */
-	assert(num_ints ? (uintptr_t)sec_intr_list : 1);
+	gicv3_spis_mark_secure(sec_map, g1s_map, g1s_num_ints, g1s_intr_list,
+			       INTR_GROUP1S);
+	gicv3_spis_mark_secure(sec_map, g1s_map, g0_num_ints, g0_intr_list,
+			       INTR_GROUP0);
 
-	for (index = 0; index < num_ints; index++) {
-		irq_num = sec_intr_list[index];
-		if (irq_num >= MIN_SPI_ID) {
+	num_ints = gicd_read_typer(gicd_base);
+	num_ints &= TYPER_IT_LINES_NO_MASK;
+	num_ints = (num_ints + 1) << 5;
 
-			/* Configure this interrupt as a secure interrupt */
-			gicd_clr_igroupr(gicd_base, irq_num);
+	/* Target the secure SPIs to the primary CPU */
+	gic_affinity_val = gicd_irouter_val_from_mpidr(read_mpidr(), 0);
 
-			/* Configure this interrupt as G0 or a G1S interrupt */
-			if (int_grp == INTR_GROUP1S)
-				gicd_set_igrpmodr(gicd_base, irq_num);
-			else
-				gicd_clr_igrpmodr(gicd_base, irq_num);
+	/*
+	 * The number of interrupts is calculated as 32 * (IT_LINES + 1). We do
+	 * 32 at a time.
+	 */
+	for (index = MIN_SPI_ID; index < num_ints; index += 32) {
+		sec = sec_map[index >> IGROUPR_SHIFT];
 
-			/* Set the priority of this interrupt */
-			gicd_set_ipriorityr(gicd_base,
-					      irq_num,
-					      GIC_HIGHEST_SEC_PRIORITY);
+		/* Configure the secure SPIs as G0 or G1S and the others G1NS */
+		gicd_write_igroupr(gicd_base, index, ~sec);
+		gicd_write_igrpmodr(gicd_base, index,
+				    g1s_map[index >> IGROUPR_SHIFT]);
 
-			/* Target SPIs to the primary CPU */
-			gic_affinity_val =
-				gicd_irouter_val_from_mpidr(read_mpidr(), 0);
-			gicd_write_irouter(gicd_base,
-					   irq_num,
-					   gic_affinity_val);
+		/* Treat all SPIs as level triggered, 16 at a time */
+		gicd_write_icfgr(gicd_base, index, 0);
+		gicd_write_icfgr(gicd_base, index + 16, 0);
+
+		/* Set the SPI priorities four at a time */
+		for (i = 0; i < 32; i += 4) {
+			pri = 0;
+			for (j = 0; j < 4; j++) {
+				prio = (sec & (1U << (i + j))) ?
+					GIC_HIGHEST_SEC_PRIORITY :
+					GIC_HIGHEST_NS_PRIORITY;
+				pri |= prio << (j << 3);
+			}
+			gicd_write_ipriorityr(gicd_base, index + i, pri);
+		}
 
-			/* Enable this interrupt */
-			gicd_set_isenabler(gicd_base, irq_num);
+		if (!sec)
+			continue;
+
+		for (i = 0; i < 32; i++) {
+			if (sec & (1U << i))
+				gicd_write_irouter(gicd_base, index + i,
+						   gic_affinity_val);
 		}
-	}
 
+		/* Enable the secure SPIs of this block */
+		gicd_write_isenabler(gicd_base, index, sec);
+	}
 }
 
 /*******************************************************************************
@@ -423,3 +454,110 @@ void gicv3_secure_ppi_sgi_configure(uintptr_t gicr_base,
 		}
 	}
 }
+
+/*******************************************************************************
+ * Registers describing a block of 32 interrupt IDs, in the order in which they
+ * are saved and restored. The interrupts are enabled last, once their
+ * attributes and state have been restored. The Redistributor SGI_base frame
+ * uses the same offsets as the Distributor, so the table is used for both.
+ * `shift` is log2 of the number of bytes each register type uses for a block of
+ * 32 interrupt IDs.
+ ******************************************************************************/
+static const struct {
+	unsigned short offset;
+	unsigned char shift;
+} gicv3_intr_block_regs[GICV3_INTR_BLOCK_REGS] = {
+	{ GICD_IGROUPR, 2 },
+	{ GICD_IGRPMODR, 2 },
+	{ GICD_ICFGR, 3 },
+	{ GICD_ICFGR + 4, 3 },
+	{ GICD_NSACR, 3 },
+	{ GICD_NSACR + 4, 3 },
+	{ GICD_IPRIORITYR, 5 },
+	{ GICD_IPRIORITYR + 4, 5 },
+	{ GICD_IPRIORITYR + 8, 5 },
+	{ GICD_IPRIORITYR + 12, 5 },
+	{ GICD_IPRIORITYR + 16, 5 },
+	{ GICD_IPRIORITYR + 20, 5 },
+	{ GICD_IPRIORITYR + 24, 5 },
+	{ GICD_IPRIORITYR + 28, 5 },
+	{ GICD_ISPENDR, 2 },
+	{ GICD_ISACTIVER, 2 },
+	{ GICD_ISENABLER, 2 },
+};
+
+/*
+ * The reset value of the ICFGR registers is IMPLEMENTATION DEFINED, so they are
+ * always saved. All the other registers reset to 0.
+ */
+#define GICV3_INTR_BLOCK_ICFGR_MAP	((1U << 2) | (1U << 3))
+
+/*
+ * Registers configuring the interrupts, i.e. all but NSACR and the pending and
+ * active state. Debug builds check that these hold their reset value when they
+ * are not restored.
+ */
+#define GICV3_INTR_BLOCK_CFG_MAP	((1U << 0) | (1U << 1) |	\
+					 GICV3_INTR_BLOCK_ICFGR_MAP |	\
+					 (0xffU << 6) | (1U << 16))
+
+/*******************************************************************************
+ * Helper function to save the state of the block `block` of 32 interrupt IDs
+ * of the GIC interface at `base`. Only the registers which do not hold their
+ * reset value are saved.
+ ******************************************************************************/
+void gicv3_intr_block_save(uintptr_t base,
+			   unsigned int block,
+			   gicv3_intr_block_ctx_t *block_ctx)
+{
+	unsigned int i, val, num_regs = 0, reg_map = 0;
+
+	assert(block_ctx);
+
+	for (i = 0; i < GICV3_INTR_BLOCK_REGS; i++) {
+		val = mmio_read_32(base + gicv3_intr_block_regs[i].offset +
+				   (block << gicv3_intr_block_regs[i].shift));
+		if (!val && !(GICV3_INTR_BLOCK_ICFGR_MAP & (1U << i)))
+			continue;
+
+		reg_map |= 1U << i;
+		block_ctx->regs[num_regs++] = val;
+	}
+
+	block_ctx->reg_map = reg_map;
+}
+
+/*******************************************************************************
+ * Helper function to restore the state of the block `block` of 32 interrupt
+ * IDs of the GIC interface at `base` saved by gicv3_intr_block_save(). Only the
+ * saved registers are written, so the interface must hold its reset values,
+ * i.e. it must have been powered down since the save. Debug builds check that
+ * the configuration registers which are not written are still 0. The pending
+ * and active state may have been set by the hardware since the power up, so it
+ * is not checked.
+ ******************************************************************************/
+void gicv3_intr_block_restore(uintptr_t base,
+			      unsigned int block,
+			      const gicv3_intr_block_ctx_t *block_ctx)
+{
+	unsigned int i, reg_map, num_regs = 0;
+	uintptr_t reg;
+
+	assert(block_ctx);
+
+	for (i = 0, reg_map = block_ctx->reg_map; i < GICV3_INTR_BLOCK_REGS;
+	     i++, reg_map >>= 1) {
+		reg = base + gicv3_intr_block_regs[i].offset +
+		      (block << gicv3_intr_block_regs[i].shift);
+
+		if (!(reg_map & 1)) {
+#if DEBUG
+			assert(!(GICV3_INTR_BLOCK_CFG_MAP & (1U << i)) ||
+			       !mmio_read_32(reg));
+#endif
+			continue;
+		}
+
+		mmio_write_32(reg, block_ctx->regs[num_regs++]);
+	}
+}
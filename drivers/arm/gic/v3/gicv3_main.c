@@ -144,26 +144,21 @@ void gicv3_distif_init(void)
 	gicd_set_ctlr(driver_data->gicd_base,
 			CTLR_ARE_S_BIT | CTLR_ARE_NS_BIT, RWP_TRUE);
 
-	/* Set the default attribute of all SPIs */
-	gicv3_spis_configure_defaults(driver_data->gicd_base);
+	/*
+	 * Set the default attribute of all SPIs and configure the G1S and G0
+	 * SPIs in a single pass over the Distributor registers
+	 */
+	gicv3_spis_configure(driver_data->gicd_base,
+			     driver_data->g1s_interrupt_num,
+			     driver_data->g1s_interrupt_array,
+			     driver_data->g0_interrupt_num,
+			     driver_data->g0_interrupt_array);
 
-	/* Configure the G1S SPIs */
-	if (driver_data->g1s_interrupt_array) {
-		gicv3_secure_spis_configure(driver_data->gicd_base,
-					driver_data->g1s_interrupt_num,
-					driver_data->g1s_interrupt_array,
-					INTR_GROUP1S);
+	if (driver_data->g1s_interrupt_array)
 		bitmap |= CTLR_ENABLE_G1S_BIT;
-	}
 
-	/* Configure the G0 SPIs */
-	if (driver_data->g0_interrupt_array) {
-		gicv3_secure_spis_configure(driver_data->gicd_base,
-					driver_data->g0_interrupt_num,
-					driver_data->g0_interrupt_array,
-					INTR_GROUP0);
+	if (driver_data->g0_interrupt_array)
 		bitmap |= CTLR_ENABLE_G0_BIT;
-	}
 
 	/* Enable the secure SPIs now that they have been configured */
 	gicd_set_ctlr(driver_data->gicd_base, bitmap, RWP_TRUE);
@@ -395,3 +390,153 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 	/* Else it is a Group 0 Secure interrupt */
 	return INTR_GROUP0;
 }
+
+/*******************************************************************************
+ * This function saves the state of the GIC Distributor in `dist_ctx` before the
+ * GIC is powered down, e.g. during system suspend. The state of each register
+ * is read 32 interrupt IDs at a time and only the registers which do not hold
+ * their reset value are kept. The routing of each SPI is read from its IROUTER
+ * register and only kept when it is not 0, its reset value, as recorded in the
+ * `irouter_map` bitmap.
+ ******************************************************************************/
+void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
+{
+	unsigned int num_ints, block, id, id_mask;
+	unsigned long long irouter;
+	uintptr_t gicd_base;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(dist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicd_base = driver_data->gicd_base;
+
+	num_ints = gicd_read_typer(gicd_base);
+	num_ints &= TYPER_IT_LINES_NO_MASK;
+	num_ints = (num_ints + 1) << 5;
+
+	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
+	dist_ctx->num_ints = num_ints;
+
+	/* Save the SPIs 32 at a time. The first block holds the SGIs/PPIs */
+	for (block = 1; block < (num_ints >> 5); block++) {
+		gicv3_intr_block_save(gicd_base, block,
+				      &dist_ctx->spi_blocks[block - 1]);
+
+		/* The special interrupt IDs 1020-1023 have no routing */
+		id_mask = 0;
+		for (id = block << 5; id < ((block + 1) << 5) &&
+		     id <= MAX_SPI_ID; id++) {
+			irouter = gicd_read_irouter(gicd_base, id);
+			if (!irouter)
+				continue;
+
+			id_mask |= 1U << (id & 0x1f);
+			dist_ctx->irouter[id - MIN_SPI_ID] = irouter;
+		}
+
+		dist_ctx->irouter_map[block - 1] = id_mask;
+	}
+}
+
+/*******************************************************************************
+ * This function restores the state of the GIC Distributor saved in `dist_ctx`
+ * by gicv3_distif_save(). Only the saved registers are written, so the
+ * Distributor must have been powered down since and hold its reset values.
+ * The interrupts are routed and configured before being enabled, and the group
+ * enables are restored last.
+ ******************************************************************************/
+void gicv3_distif_restore(const gicv3_dist_ctx_t * const dist_ctx)
+{
+	unsigned int block, id, id_mask;
+	uintptr_t gicd_base;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(dist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicd_base = driver_data->gicd_base;
+
+	/*
+	 * Clear the "enable" bits for G0/G1S/G1NS interrupts before configuring
+	 * the ARE_S bit. The Distributor might generate a system error
+	 * otherwise.
+	 */
+	gicd_clr_ctlr(gicd_base,
+		      CTLR_ENABLE_G0_BIT |
+		      CTLR_ENABLE_G1S_BIT |
+		      CTLR_ENABLE_G1NS_BIT,
+		      RWP_TRUE);
+
+	/* Set the ARE_S and ARE_NS bit now that interrupts have been disabled */
+	gicd_set_ctlr(gicd_base, CTLR_ARE_S_BIT | CTLR_ARE_NS_BIT, RWP_TRUE);
+
+	for (block = 1; block < (dist_ctx->num_ints >> 5); block++) {
+		id_mask = dist_ctx->irouter_map[block - 1];
+
+		for (id = block << 5; id_mask; id++, id_mask >>= 1) {
+			if (id_mask & 1)
+				gicd_write_irouter(gicd_base, id,
+					dist_ctx->irouter[id - MIN_SPI_ID]);
+		}
+
+		gicv3_intr_block_restore(gicd_base, block,
+					 &dist_ctx->spi_blocks[block - 1]);
+	}
+
+	/* Restore the group enables now that the SPIs have been configured */
+	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
+	gicd_wait_for_pending_write(gicd_base);
+}
+
+/*******************************************************************************
+ * This function saves the state of the SGIs and PPIs of the GIC Redistributor
+ * interface of the CPU identified by the 'proc_num' parameter in `rdist_ctx`.
+ ******************************************************************************/
+void gicv3_rdistif_save(unsigned int proc_num,
+			gicv3_redist_ctx_t * const rdist_ctx)
+{
+	uintptr_t gicr_base;
+
+	assert(driver_data);
+	assert(proc_num < driver_data->rdistif_num);
+	assert(driver_data->rdistif_base_addrs);
+	assert(rdist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicr_base = driver_data->rdistif_base_addrs[proc_num];
+
+	gicv3_intr_block_save(gicr_base + GICR_SGIBASE_OFFSET, 0,
+			      &rdist_ctx->ppi_sgi_block);
+}
+
+/*******************************************************************************
+ * This function restores the state of the SGIs and PPIs of the GIC
+ * Redistributor interface of the CPU identified by the 'proc_num' parameter
+ * saved in `rdist_ctx` by gicv3_rdistif_save(). It must be called after the
+ * Distributor state has been restored.
+ ******************************************************************************/
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t * const rdist_ctx)
+{
+	uintptr_t gicr_base;
+
+	assert(driver_data);
+	assert(proc_num < driver_data->rdistif_num);
+	assert(driver_data->rdistif_base_addrs);
+	assert(driver_data->gicd_base);
+	assert(gicd_read_ctlr(driver_data->gicd_base) & CTLR_ARE_S_BIT);
+	assert(rdist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicr_base = driver_data->rdistif_base_addrs[proc_num];
+
+	gicv3_intr_block_restore(gicr_base + GICR_SGIBASE_OFFSET, 0,
+				 &rdist_ctx->ppi_sgi_block);
+}
@@ -55,6 +55,12 @@
 		;						\
 	} while (gicd_read_ctlr(gicd_base) & GICD_CTLR_RWP_BIT)
 
+/*
+ * Number of interrupt IDs covered by the largest Distributor, i.e. 32 *
+ * (GICD_TYPER.ITLinesNumber + 1) for the maximum value of the field
+ */
+#define GICD_MAX_INTR_ID	((TYPER_IT_LINES_NO_MASK + 1) << 5)
+
 /*
  * Macro to convert an mpidr to a value suitable for programming into a
  * GICD_IROUTER. Bits[31:24] in the MPIDR are cleared as they are not relevant
@@ -119,12 +125,12 @@ void gicr_set_ipriorityr(uintptr_t base, unsigned int id, unsigned int pri);
 /*******************************************************************************
  * Private GICv3 helper function prototypes
  ******************************************************************************/
-void gicv3_spis_configure_defaults(uintptr_t gicd_base);
+void gicv3_spis_configure(uintptr_t gicd_base,
+			  unsigned int g1s_num_ints,
+			  const unsigned int *g1s_intr_list,
+			  unsigned int g0_num_ints,
+			  const unsigned int *g0_intr_list);
 void gicv3_ppi_sgi_configure_defaults(uintptr_t gicr_base);
-void gicv3_secure_spis_configure(uintptr_t gicd_base,
-				     unsigned int num_ints,
-				     const unsigned int *sec_intr_list,
-				     unsigned int int_grp);
 void gicv3_secure_ppi_sgi_configure(uintptr_t gicr_base,
 					unsigned int num_ints,
 					const unsigned int *sec_intr_list,
@@ -133,6 +139,12 @@ void gicv3_rdistif_base_addrs_probe(uintptr_t *rdistif_base_addrs,
 					unsigned int rdistif_num,
 					uintptr_t gicr_base,
 					mpidr_hash_fn mpidr_to_core_pos);
+void gicv3_intr_block_save(uintptr_t base,
+			   unsigned int block,
+			   gicv3_intr_block_ctx_t *block_ctx);
+void gicv3_intr_block_restore(uintptr_t base,
+			      unsigned int block,
+			      const gicv3_intr_block_ctx_t *block_ctx);
 void gicv3_rdistif_mark_core_awake(uintptr_t gicr_base);
 void gicv3_rdistif_mark_core_asleep(uintptr_t gicr_base);
 
@@ -54,6 +54,11 @@
 extern const auth_img_desc_t *const cot_desc_ptr;
 extern unsigned int auth_img_flags[];
 
+/* Image whose hash is being computed incrementally while it is loaded */
+static unsigned int hash_stream_img_id;
+static unsigned int hash_stream_len;
+static int hash_stream_active;
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -129,6 +134,14 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			img, img_len, &data_ptr, &data_len);
 	return_if_error(rc);
 
+	/* If the whole data has been hashed while loading, just match it */
+	if (hash_stream_active && (hash_stream_img_id == img_desc->img_id) &&
+	    (data_ptr == img) && (data_len == hash_stream_len)) {
+		hash_stream_active = 0;
+		return crypto_mod_verify_hash_final();
+	}
+	hash_stream_active = 0;
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -343,6 +356,85 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Start hashing an image incrementally, as its data is passed to
+ * auth_mod_hash_img_update() while it is being loaded. auth_mod_verify_img()
+ * then only has to match the result. This is possible for raw images
+ * authenticated by hash whose parent has already been authenticated.
+ *
+ * Return value:
+ *   0 = Incremental hashing started, 1 = The image must be hashed in one go
+ */
+int auth_mod_hash_img_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_desc_t *auth_method = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	hash_stream_active = 0;
+
+	/* Get the image descriptor */
+	img_desc = &cot_desc_ptr[img_id];
+
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL) ||
+	    !(auth_img_flags[img_desc->parent->img_id] &
+	      IMG_FLAG_AUTHENTICATED)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_HASH) {
+			break;
+		}
+	}
+	if (i == AUTH_METHOD_NUM) {
+		return 1;
+	}
+
+	/*
+	 * Get the hash from the parent image. On any error, leave it to
+	 * auth_mod_verify_img() to hash the image and report the error.
+	 */
+	rc = auth_get_param(auth_method->param.hash.hash, img_desc->parent,
+			&hash_der_ptr, &hash_der_len);
+	if (rc != 0) {
+		return 1;
+	}
+
+	rc = crypto_mod_verify_hash_init(hash_der_ptr, hash_der_len);
+	if (rc != 0) {
+		return 1;
+	}
+
+	hash_stream_img_id = img_id;
+	hash_stream_len = 0;
+	hash_stream_active = 1;
+
+	return 0;
+}
+
+/*
+ * Pass the next block of the image started with auth_mod_hash_img_start().
+ * Does nothing if no image is being hashed incrementally.
+ */
+void auth_mod_hash_img_update(void *data_ptr, unsigned int data_len)
+{
+	if (!hash_stream_active) {
+		return;
+	}
+
+	/* On error, the image will be hashed in one go when verified */
+	if (crypto_mod_verify_hash_update(data_ptr, data_len) != 0) {
+		hash_stream_active = 0;
+		return;
+	}
+
+	hash_stream_len += data_len;
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -127,3 +127,51 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start verifying a hash incrementally
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ *
+ * Returns CRYPTO_ERR_UNKNOWN if the library does not support it.
+ */
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if (crypto_lib_desc.verify_hash_init == NULL)
+		return CRYPTO_ERR_UNKNOWN;
+
+	return crypto_lib_desc.verify_hash_init(digest_info_ptr,
+						digest_info_len);
+}
+
+/*
+ * Add data to the hash started by crypto_mod_verify_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: next block of data to be hashed
+ */
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(crypto_lib_desc.verify_hash_update != NULL);
+
+	return crypto_lib_desc.verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Compare the hash started by crypto_mod_verify_hash_init() with the expected
+ * value
+ */
+int crypto_mod_verify_hash_final(void)
+{
+	assert(crypto_lib_desc.verify_hash_final != NULL);
+
+	return crypto_lib_desc.verify_hash_final();
+}
@@ -156,19 +156,18 @@ end:
 }
 
 /*
- * Match a hash
+ * Parse a DigestInfo structure
  *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Return the hash algorithm in 'md_info' and a pointer to the hash value in
+ * 'hash'.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -192,8 +191,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -204,10 +203,32 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
+		return CRYPTO_ERR_HASH;
+	}
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -225,7 +246,99 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * State of the hash being verified incrementally. The expected value is
+ * copied so that the caller's buffer need not outlive the init call.
+ */
+static mbedtls_md_context_t stream_ctx;
+static unsigned char stream_hash[MBEDTLS_MD_MAX_SIZE];
+
+/*
+ * Start matching a hash incrementally
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash_init(void *digest_info_ptr,
+			    unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Release any computation that was not finalised */
+	mbedtls_md_free(&stream_ctx);
+	mbedtls_md_init(&stream_ctx);
+
+	rc = mbedtls_md_setup(&stream_ctx, md_info, 0);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_starts(&stream_ctx);
+	if (rc != 0) {
+		mbedtls_md_free(&stream_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	memcpy(stream_hash, hash, mbedtls_md_get_size(md_info));
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add a block of data to the hash started by verify_hash_init()
+ */
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	rc = mbedtls_md_update(&stream_ctx, (unsigned char *)data_ptr,
+			       data_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the hash started by verify_hash_init() and match it
+ */
+static int verify_hash_final(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char size;
+	int rc;
+
+	if (stream_ctx.md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+	size = mbedtls_md_get_size(stream_ctx.md_info);
+
+	rc = mbedtls_md_finish(&stream_ctx, data_hash);
+	mbedtls_md_free(&stream_ctx);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, stream_hash, size);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_HASH_STREAM(LIB_NAME, init, verify_signature, verify_hash,
+				verify_hash_init, verify_hash_update,
+				verify_hash_final);
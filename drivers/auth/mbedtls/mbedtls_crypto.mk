@@ -68,5 +68,28 @@ endif
 # mbed TLS libraries rely on this define to build correctly
 $(eval $(call add_define,MBEDTLS_KEY_ALG_ID))
 
+# The platform may define the variable 'MBEDTLS_HASH_ACCEL' to replace the
+# mbed TLS SHA-256 implementation with a hardware accelerated one. A portable
+# implementation is still used if the CPU does not support the accelerator.
+# Default is none.
+ifeq (${MBEDTLS_HASH_ACCEL},)
+    MBEDTLS_HASH_ACCEL		:=	none
+endif
+
+ifeq (${MBEDTLS_HASH_ACCEL},armv8_ce)
+    ifneq (${ARCH},aarch64)
+        $(error "MBEDTLS_HASH_ACCEL=armv8_ce requires ARCH=aarch64")
+    endif
+    MBEDTLS_CRYPTO_SOURCES	+=	drivers/auth/mbedtls/mbedtls_sha256_accel.c \
+					drivers/auth/mbedtls/aarch64/sha256_armv8_ce.S
+    MBEDTLS_HASH_ACCEL_ID	:=	MBEDTLS_HASH_ACCEL_ARMV8_CE
+else ifeq (${MBEDTLS_HASH_ACCEL},none)
+    MBEDTLS_HASH_ACCEL_ID	:=	MBEDTLS_HASH_ACCEL_NONE
+else
+    $(error "MBEDTLS_HASH_ACCEL=${MBEDTLS_HASH_ACCEL} not supported on mbed TLS")
+endif
+
+$(eval $(call add_define,MBEDTLS_HASH_ACCEL_ID))
+
 BL1_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
 BL2_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
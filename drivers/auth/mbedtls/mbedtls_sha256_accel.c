@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <arch.h>
+#include <arch_helpers.h>
+#include <debug.h>
+#include <mbedtls_sha256_accel.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+
+/*
+ * SHA-256 implementation used by mbed TLS when MBEDTLS_SHA256_ALT is defined.
+ * Whole blocks of input are handed to the accelerator selected at build time
+ * in a single call, or to a portable implementation if the CPU does not
+ * provide it or if it fails the known-answer test run on first use.
+ */
+
+#define GET_UINT32_BE(b, i)				\
+	(((uint32_t)(b)[(i)] << 24) |			\
+	 ((uint32_t)(b)[(i) + 1] << 16) |		\
+	 ((uint32_t)(b)[(i) + 2] << 8) |		\
+	 ((uint32_t)(b)[(i) + 3]))
+
+#define PUT_UINT32_BE(n, b, i)				\
+	do {						\
+		(b)[(i)] = (unsigned char)((n) >> 24);	\
+		(b)[(i) + 1] = (unsigned char)((n) >> 16); \
+		(b)[(i) + 2] = (unsigned char)((n) >> 8); \
+		(b)[(i) + 3] = (unsigned char)(n);	\
+	} while (0)
+
+#define ROTR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+#define S0(x)		(ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define S1(x)		(ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+#define S2(x)		(ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define S3(x)		(ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define F0(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+#define F1(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+
+/* Round constants, also used by the accelerators */
+const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t sha256_h0[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t sha224_h0[8] = {
+	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+};
+
+/* Portable implementation of the SHA-256 block function */
+static void sha256_process_generic(uint32_t state[8],
+				   const unsigned char *data, size_t blocks)
+{
+	uint32_t w[64], v[8], t1, t2;
+	int i;
+
+	for (; blocks > 0; blocks--, data += 64) {
+		for (i = 0; i < 16; i++)
+			w[i] = GET_UINT32_BE(data, 4 * i);
+		for (; i < 64; i++)
+			w[i] = S1(w[i - 2]) + w[i - 7] + S0(w[i - 15]) +
+			       w[i - 16];
+
+		for (i = 0; i < 8; i++)
+			v[i] = state[i];
+
+		for (i = 0; i < 64; i++) {
+			t1 = v[7] + S3(v[4]) + F1(v[4], v[5], v[6]) +
+			     sha256_k[i] + w[i];
+			t2 = S2(v[0]) + F0(v[0], v[1], v[2]);
+			v[7] = v[6];
+			v[6] = v[5];
+			v[5] = v[4];
+			v[4] = v[3] + t1;
+			v[3] = v[2];
+			v[2] = v[1];
+			v[1] = v[0];
+			v[0] = t1 + t2;
+		}
+
+		for (i = 0; i < 8; i++)
+			state[i] += v[i];
+	}
+}
+
+#if (MBEDTLS_HASH_ACCEL_ID == MBEDTLS_HASH_ACCEL_ARMV8_CE)
+
+/* Single padded block of the message "abc" and its SHA-256 */
+static const unsigned char kat_block[64] = {
+	0x61, 0x62, 0x63, 0x80, [63] = 0x18
+};
+
+static const uint32_t kat_digest[8] = {
+	0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223,
+	0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad,
+};
+
+/*
+ * Return 1 if the SHA-256 instructions are implemented and produce the
+ * expected result, 0 otherwise. Evaluated once.
+ */
+static int accel_available(void)
+{
+	static int available = -1;
+	uint32_t state[8];
+	unsigned int sha2;
+
+	if (available >= 0)
+		return available;
+
+	available = 0;
+	sha2 = (read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+	       ID_AA64ISAR0_SHA2_MASK;
+	if (sha2 == 0) {
+		INFO("SHA-256 instructions not implemented\n");
+		return available;
+	}
+
+	memcpy(state, sha256_h0, sizeof(state));
+	sha256_armv8_ce_process(state, kat_block, 1);
+	if (memcmp(state, kat_digest, sizeof(state)) != 0) {
+		WARN("SHA-256 instructions failed known-answer test\n");
+		return available;
+	}
+
+	available = 1;
+	return available;
+}
+
+#define accel_process(state, data, blocks)	\
+	sha256_armv8_ce_process(state, data, blocks)
+
+#elif (MBEDTLS_HASH_ACCEL_ID == MBEDTLS_HASH_ACCEL_NONE)
+
+/* Portable implementation only, as built by the host known-answer test */
+#define accel_available()			0
+#define accel_process(state, data, blocks)	\
+	sha256_process_generic(state, data, blocks)
+
+#else
+#error "Unsupported MBEDTLS_HASH_ACCEL_ID"
+#endif /* MBEDTLS_HASH_ACCEL_ID */
+
+/* Update the state with 'blocks' 64-byte blocks of data */
+static void sha256_process_blocks(uint32_t state[8],
+				  const unsigned char *data, size_t blocks)
+{
+	if (accel_available())
+		accel_process(state, data, blocks);
+	else
+		sha256_process_generic(state, data, blocks);
+}
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
+{
+	if (ctx == NULL)
+		return;
+
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst,
+			  const mbedtls_sha256_context *src)
+{
+	*dst = *src;
+}
+
+void mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
+{
+	ctx->total[0] = 0;
+	ctx->total[1] = 0;
+	memcpy(ctx->state, is224 ? sha224_h0 : sha256_h0, sizeof(ctx->state));
+	ctx->is224 = is224;
+}
+
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx,
+			    const unsigned char data[64])
+{
+	sha256_process_blocks(ctx->state, data, 1);
+}
+
+void mbedtls_sha256_update(mbedtls_sha256_context *ctx,
+			   const unsigned char *input, size_t ilen)
+{
+	size_t fill, left, blocks;
+
+	if (ilen == 0)
+		return;
+
+	left = ctx->total[0] & 0x3f;
+	fill = 64 - left;
+
+	ctx->total[0] += (uint32_t)ilen;
+	if (ctx->total[0] < (uint32_t)ilen)
+		ctx->total[1]++;
+	ctx->total[1] += (uint32_t)((uint64_t)ilen >> 32);
+
+	/* Complete the block already started */
+	if ((left != 0) && (ilen >= fill)) {
+		memcpy(ctx->buffer + left, input, fill);
+		sha256_process_blocks(ctx->state, ctx->buffer, 1);
+		input += fill;
+		ilen -= fill;
+		left = 0;
+	}
+
+	/* Process all whole blocks straight from the input */
+	if (left == 0) {
+		blocks = ilen / 64;
+		if (blocks != 0) {
+			sha256_process_blocks(ctx->state, input, blocks);
+			input += blocks * 64;
+			ilen -= blocks * 64;
+		}
+	}
+
+	if (ilen != 0)
+		memcpy(ctx->buffer + left, input, ilen);
+}
+
+void mbedtls_sha256_finish(mbedtls_sha256_context *ctx,
+			   unsigned char output[32])
+{
+	unsigned char msglen[8];
+	uint32_t high, low;
+	size_t last, padn;
+	int i;
+	static const unsigned char padding[64] = { 0x80 };
+
+	high = (ctx->total[0] >> 29) | (ctx->total[1] << 3);
+	low = ctx->total[0] << 3;
+	PUT_UINT32_BE(high, msglen, 0);
+	PUT_UINT32_BE(low, msglen, 4);
+
+	last = ctx->total[0] & 0x3f;
+	padn = (last < 56) ? (56 - last) : (120 - last);
+
+	mbedtls_sha256_update(ctx, padding, padn);
+	mbedtls_sha256_update(ctx, msglen, 8);
+
+	for (i = 0; i < (ctx->is224 ? 7 : 8); i++)
+		PUT_UINT32_BE(ctx->state[i], output, 4 * i);
+}
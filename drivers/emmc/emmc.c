@@ -42,6 +42,11 @@ static unsigned int emmc_ocr_value;
 static emmc_csd_t emmc_csd;
 static unsigned int emmc_flags;
 
+/* Read started by emmc_read_blocks_start(), if emmc_read_size is not zero */
+static int emmc_read_lba;
+static uintptr_t emmc_read_buf;
+static size_t emmc_read_size;
+
 static int is_cmd23_enabled(void)
 {
 	return (!!(emmc_flags & EMMC_FLAG_CMD23));
@@ -166,13 +171,19 @@ static int emmc_enumerate(int clk, int bus_width)
 	return ret;
 }
 
-size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
+/*
+ * Start reading blocks: the read command is issued and the data is transferred
+ * by the controller while the caller does something else, until
+ * emmc_read_blocks_wait() is called. Only one read may be in flight.
+ */
+int emmc_read_blocks_start(int lba, uintptr_t buf, size_t size)
 {
 	emmc_cmd_t cmd;
 	int ret;
 
 	assert((ops != 0) &&
 	       (ops->read != 0) &&
+	       (emmc_read_size == 0) &&
 	       ((buf & EMMC_BLOCK_MASK) == 0) &&
 	       ((size & EMMC_BLOCK_MASK) == 0));
 
@@ -205,7 +216,22 @@ size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	ret = ops->send_cmd(&cmd);
 	assert(ret == 0);
 
-	ret = ops->read(lba, buf, size);
+	emmc_read_lba = lba;
+	emmc_read_buf = buf;
+	emmc_read_size = size;
+	return ret;
+}
+
+/* Wait for the read started by emmc_read_blocks_start() to complete */
+size_t emmc_read_blocks_wait(void)
+{
+	emmc_cmd_t cmd;
+	size_t size = emmc_read_size;
+	int ret;
+
+	assert(size != 0);
+
+	ret = ops->read(emmc_read_lba, emmc_read_buf, size);
 	assert(ret == 0);
 
 	/* wait buffer empty */
@@ -219,11 +245,31 @@ size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
 			assert(ret == 0);
 		}
 	}
+
+	/*
+	 * The caller may have run while the data was being transferred, so
+	 * lines of the buffer may have been fetched speculatively. Discard them.
+	 */
+	inv_dcache_range(emmc_read_buf, size);
+
+	emmc_read_size = 0;
 	/* Ignore improbable errors in release builds */
 	(void)ret;
 	return size;
 }
 
+size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	int ret;
+
+	ret = emmc_read_blocks_start(lba, buf, size);
+	assert(ret == 0);
+
+	/* Ignore improbable errors in release builds */
+	(void)ret;
+	return emmc_read_blocks_wait();
+}
+
 size_t emmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	emmc_cmd_t cmd;
@@ -42,6 +42,11 @@ typedef struct {
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+	/* Read started by block_read_start(), if async_length is not zero */
+	size_t			async_length;
+	size_t			async_middle;
+	uintptr_t		async_tail_buf;
+	size_t			async_tail;
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -53,6 +58,9 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length);
+static int block_read_wait(io_entity_t *entity, size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
@@ -73,6 +81,8 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.close		= block_close,
 	.dev_init	= NULL,
 	.dev_close	= block_dev_close,
+	.read_start	= block_read_start,
+	.read_wait	= block_read_wait,
 };
 
 static block_dev_state_t state_pool[MAX_IO_BLOCK_DEVICES];
@@ -161,6 +171,7 @@ static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	cur->base = region->offset;
 	cur->size = region->length;
 	cur->file_pos = 0;
+	cur->async_length = 0;
 
 	entity->info = (uintptr_t)cur;
 	return 0;
@@ -190,112 +201,186 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+/*
+ * Read from the block device. Only a partial block at the head or tail of the
+ * request is staged through the block buffer. The block aligned middle part is
+ * read straight into the caller's buffer with a single multi-block request
+ * when the destination is block aligned, and falls back to the block buffer in
+ * chunks of buf->length otherwise.
+ */
+/* Largest size passed to a single read() or read_start() of the device */
+static size_t block_max_read_size(const io_block_dev_spec_t *dev_spec)
+{
+	if (dev_spec->max_read_size != 0)
+		return dev_spec->max_read_size;
+	return dev_spec->buffer.length;
+}
+
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
 {
 	block_dev_state_t *cur;
 	io_block_spec_t *buf;
 	io_block_ops_t *ops;
-	size_t aligned_length, skip, count, left, padding, block_size;
+	size_t skip, count, left, size, block_size, max_size;
 	int lba;
-	int buffer_not_aligned;
 
 	assert(entity->info != (uintptr_t)NULL);
 	cur = (block_dev_state_t *)entity->info;
 	ops = &(cur->dev_spec->ops);
 	buf = &(cur->dev_spec->buffer);
 	block_size = cur->dev_spec->block_size;
+	max_size = block_max_read_size(cur->dev_spec);
 	assert((length <= cur->size) &&
 	       (length > 0) &&
 	       (ops->read != 0));
 
-	if ((buffer & (block_size - 1)) != 0) {
-		/*
-		 * buffer isn't aligned with block size.
-		 * Block device always relies on DMA operation.
-		 * It's better to make the buffer as block size aligned.
-		 */
-		buffer_not_aligned = 1;
-	} else {
-		buffer_not_aligned = 0;
-	}
-
-	skip = cur->file_pos % block_size;
-	aligned_length = ((skip + length) + (block_size - 1)) &
-			 ~(block_size - 1);
-	padding = aligned_length - (skip + length);
-	left = aligned_length;
-	do {
+	left = length;
+	while (left > 0) {
 		lba = (cur->file_pos + cur->base) / block_size;
-		if (left >= buf->length) {
+		skip = cur->file_pos % block_size;
+		if ((skip != 0) || (left < block_size)) {
 			/*
-			 * Since left is larger, it's impossible to padding.
-			 *
-			 * If buffer isn't aligned, we need to use aligned
-			 * buffer instead.
+			 * Unaligned head or partial tail. Read the whole
+			 * block into the block buffer and only copy out the
+			 * requested part of it.
 			 */
-			if (skip || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we need to use
-				 * block buffer to read block. Since block
-				 * device is always relied on DMA operation.
-				 */
-				count = ops->read(lba, buf->offset,
-						  buf->length);
-			} else {
-				count = ops->read(lba, buffer, buf->length);
-			}
-			assert(count == buf->length);
-			cur->file_pos += count - skip;
-			if (skip || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size caused
-				 * by skip or not aligned buffer, block buffer
-				 * is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       count - skip);
-			}
-			left = left - (count - skip);
+			count = ops->read(lba, buf->offset, block_size);
+			assert(count == block_size);
+			size = block_size - skip;
+			if (size > left)
+				size = left;
+			memcpy((void *)buffer, (void *)(buf->offset + skip),
+			       size);
+		} else if ((buffer & (block_size - 1)) == 0) {
+			/*
+			 * Both file_pos and buffer are block aligned. Issue
+			 * requests as large as the device accepts for the
+			 * remaining whole blocks directly into the
+			 * destination, without any copy.
+			 */
+			size = left & ~(block_size - 1);
+			if (size > max_size)
+				size = max_size;
+			count = ops->read(lba, buffer, size);
+			assert(count == size);
 		} else {
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we have to read
-				 * full block by block buffer instead.
-				 * The size isn't aligned with block size.
-				 * Use block buffer to avoid overflow.
-				 *
-				 * If buffer isn't aligned, use block buffer
-				 * to avoid DMA error.
-				 */
-				count = ops->read(lba, buf->offset, left);
-			} else
-				count = ops->read(lba, buffer, left);
-			assert(count == left);
-			left = left - (skip + padding);
-			cur->file_pos += left;
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size or
-				 * buffer, block buffer is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       left);
-			}
-			/* It's already the last block operation */
-			left = 0;
+			/*
+			 * buffer isn't aligned with block size. Block device
+			 * always relies on DMA operation, so whole blocks go
+			 * through the block buffer instead.
+			 */
+			size = left & ~(block_size - 1);
+			if (size > buf->length)
+				size = buf->length;
+			if (size > max_size)
+				size = max_size;
+			count = ops->read(lba, buf->offset, size);
+			assert(count == size);
+			memcpy((void *)buffer, (void *)buf->offset, size);
 		}
-		skip = cur->file_pos % block_size;
-	} while (left > 0);
+		buffer += size;
+		cur->file_pos += size;
+		left -= size;
+	}
 	*length_read = length;
 
 	return 0;
 }
 
+/*
+ * Start reading from the block device. The partial block at the head of the
+ * request is read synchronously through the block buffer, and the block
+ * aligned middle part is queued with ops->read_start() straight into the
+ * caller's buffer. The partial block at the tail, if any, is read by
+ * block_read_wait() once the middle part has completed.
+ *
+ * Returns -ENODEV if the device cannot read asynchronously, or if the middle
+ * part would not land block aligned in the caller's buffer, in which case the
+ * caller should use block_read() instead.
+ */
+static int block_read_start(io_entity_t *entity, uintptr_t buffer,
+			    size_t length)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t skip, head, middle, len, block_size;
+	int lba, result;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	block_size = cur->dev_spec->block_size;
+	assert((length <= cur->size) &&
+	       (length > 0) &&
+	       (cur->async_length == 0));
+
+	if ((ops->read_start == NULL) || (ops->read_wait == NULL))
+		return -ENODEV;
+
+	skip = cur->file_pos % block_size;
+	head = (skip != 0) ? block_size - skip : 0;
+	if (head > length)
+		head = length;
+	middle = (length - head) & ~(block_size - 1);
+	if ((((buffer + head) & (block_size - 1)) != 0) ||
+	    (middle > block_max_read_size(cur->dev_spec)))
+		return -ENODEV;
+
+	if (head != 0) {
+		result = block_read(entity, buffer, head, &len);
+		if (result != 0)
+			return result;
+	}
+
+	cur->async_middle = middle;
+	cur->async_tail_buf = buffer + head + cur->async_middle;
+	cur->async_tail = length - head - cur->async_middle;
+	cur->async_length = length;
+
+	if (cur->async_middle != 0) {
+		lba = (cur->file_pos + cur->base) / block_size;
+		result = ops->read_start(lba, buffer + head,
+					 cur->async_middle);
+		if (result != 0) {
+			cur->async_length = 0;
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* Wait for the read started by block_read_start() and finish it */
+static int block_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t count, len;
+	int result = 0;
+
+	assert(entity->info != (uintptr_t)NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	assert(cur->async_length != 0);
+
+	if (cur->async_middle != 0) {
+		count = ops->read_wait();
+		assert(count == cur->async_middle);
+		cur->file_pos += count;
+	}
+
+	if (cur->async_tail != 0)
+		result = block_read(entity, cur->async_tail_buf,
+				    cur->async_tail, &len);
+
+	if (result == 0)
+		*length_read = cur->async_length;
+	cur->async_length = 0;
+
+	return result;
+}
+
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written)
 {
@@ -415,7 +500,9 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	assert((block_size > 0) &&
 	       (is_power_of_2(block_size) != 0) &&
 	       ((buffer->offset % block_size) == 0) &&
-	       ((buffer->length % block_size) == 0));
+	       ((buffer->length % block_size) == 0) &&
+	       (buffer->length >= block_size) &&
+	       ((cur->dev_spec->max_read_size % block_size) == 0));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
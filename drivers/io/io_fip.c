@@ -30,16 +30,19 @@
 
 #include <assert.h>
 #include <bl_common.h>
+#include <cassert.h>
 #include <debug.h>
 #include <errno.h>
 #include <firmware_image_package.h>
 #include <io_driver.h>
 #include <io_fip.h>
 #include <io_storage.h>
+#include <lz4.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
 #include <string.h>
+#include <utils.h>
 #include <uuid.h>
 
 /* Useful for printing UUIDs when debugging.*/
@@ -57,12 +60,76 @@ typedef struct {
 	 */
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/* Size of the file, once decompressed if the payload is compressed */
+	size_t size;
+	/* The FIP on the backend, open for as long as the file is open */
+	uintptr_t backend_handle;
+#if FIP_LZ4
+	/*
+	 * Bytes of the compressed payload read so far, and the part of
+	 * fip_lz4_buf that is still to be decompressed.
+	 */
+	size_t src_pos;
+	size_t src_off;
+	size_t src_len;
+	lz4_stream_t lz4;
+#endif
 } file_state_t;
 
+/*
+ * Maximum number of ToC entries held in the in-memory index. A platform may
+ * override this in platform_def.h. If a FIP contains more entries, files are
+ * still found by scanning the ToC on the backend.
+ */
+#ifndef FIP_MAX_TOC_ENTRIES
+#define FIP_MAX_TOC_ENTRIES	32
+#endif
+
+/* Number of hash buckets used to look up a ToC entry by UUID */
+#define FIP_TOC_HASH_SIZE	(2 * FIP_MAX_TOC_ENTRIES)
+
+CASSERT(FIP_MAX_TOC_ENTRIES < UINT8_MAX, assert_fip_max_toc_entries);
+CASSERT(IS_POWER_OF_TWO(FIP_TOC_HASH_SIZE), assert_fip_toc_hash_size);
+
+#if FIP_LZ4
+/*
+ * Size of the buffer compressed payloads are read through before being
+ * decompressed into their destination. A platform may override this in
+ * platform_def.h. The buffer is aligned to the usual block size of block
+ * devices so that the backend can read into it without a copy.
+ */
+#ifndef FIP_LZ4_BUF_SIZE
+#define FIP_LZ4_BUF_SIZE	0x1000
+#endif
+
+CASSERT(FIP_LZ4_BUF_SIZE >= sizeof(fip_compressed_header_t),
+	assert_fip_lz4_buf_size);
+
+static uint8_t fip_lz4_buf[FIP_LZ4_BUF_SIZE] __aligned(512);
+#endif
+
+/*
+ * Index of the ToC built once by fip_dev_init(). It is kept until
+ * fip_dev_close() so that opening a file does not read the ToC again. The
+ * backend is only kept open while a file is open, so that other users of a
+ * backend that supports a single open file can access it in between.
+ */
+typedef struct {
+	int		valid;
+	unsigned int	image_id;
+	unsigned int	num_entries;
+	/* Non-zero if every ToC entry fitted in 'entries' */
+	int		complete;
+	fip_toc_entry_t	entries[FIP_MAX_TOC_ENTRIES];
+	/* Index into 'entries' plus one, zero for an empty bucket */
+	uint8_t		hash[FIP_TOC_HASH_SIZE];
+} fip_toc_index_t;
+
 static const uuid_t uuid_null = {0};
 static file_state_t current_file = {0};
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
+static fip_toc_index_t toc_index;
 
 
 /* Firmware Image Package driver functions */
@@ -72,6 +139,9 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length);
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -84,6 +154,90 @@ static inline int compare_uuids(const uuid_t *uuid1, const uuid_t *uuid2)
 }
 
 
+static inline unsigned int uuid_hash(const uuid_t *uuid)
+{
+	return uuid->time_low & (FIP_TOC_HASH_SIZE - 1);
+}
+
+
+/* Add an entry to the ToC index. Return 0 on success, -ENOMEM if full. */
+static int toc_index_add(const fip_toc_entry_t *entry)
+{
+	unsigned int bucket;
+
+	if (toc_index.num_entries == FIP_MAX_TOC_ENTRIES)
+		return -ENOMEM;
+
+	toc_index.entries[toc_index.num_entries] = *entry;
+	toc_index.num_entries++;
+
+	/* Linear probing, the table is never more than half full */
+	bucket = uuid_hash(&entry->uuid);
+	while (toc_index.hash[bucket] != 0)
+		bucket = (bucket + 1) & (FIP_TOC_HASH_SIZE - 1);
+	toc_index.hash[bucket] = (uint8_t)toc_index.num_entries;
+
+	return 0;
+}
+
+
+/* Look up an entry in the ToC index. Return NULL if not present. */
+static const fip_toc_entry_t *toc_index_find(const uuid_t *uuid)
+{
+	unsigned int bucket = uuid_hash(uuid);
+	const fip_toc_entry_t *entry;
+
+	while (toc_index.hash[bucket] != 0) {
+		entry = &toc_index.entries[toc_index.hash[bucket] - 1];
+		if (compare_uuids(&entry->uuid, uuid) == 0)
+			return entry;
+		bucket = (bucket + 1) & (FIP_TOC_HASH_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+
+/* Forget the ToC index */
+static void toc_index_reset(void)
+{
+	memset(&toc_index, 0, sizeof(toc_index));
+}
+
+
+/*
+ * Scan the ToC on the backend for the given UUID. Only used when the ToC did
+ * not fit in the index.
+ */
+static int toc_scan(uintptr_t backend_handle, const uuid_t *uuid,
+		    fip_toc_entry_t *entry)
+{
+	int result;
+	size_t bytes_read;
+
+	/* Seek past the FIP header into the Table of Contents */
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 sizeof(fip_toc_header_t));
+	if (result != 0) {
+		WARN("fip_file_open: failed to seek\n");
+		return -ENOENT;
+	}
+
+	do {
+		result = io_read(backend_handle, (uintptr_t)entry,
+				 sizeof(*entry), &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return result;
+		}
+		if (compare_uuids(&entry->uuid, uuid) == 0)
+			return 0;
+	} while (compare_uuids(&entry->uuid, &uuid_null) != 0);
+
+	return -ENOENT;
+}
+
+
 /* TODO: We could check version numbers or do a package checksum? */
 static inline int is_valid_header(fip_toc_header_t *header)
 {
@@ -117,6 +271,8 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
+	.read_start = fip_file_read_start,
+	.read_wait = fip_file_read_wait,
 };
 
 
@@ -138,15 +294,25 @@ static int fip_dev_open(const uintptr_t dev_spec __unused,
 }
 
 
-/* Do some basic package checks. */
+/*
+ * Do some basic package checks, then build the ToC index for subsequent file
+ * accesses.
+ */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
 	uintptr_t backend_handle;
 	fip_toc_header_t header;
+	fip_toc_entry_t entry;
 	size_t bytes_read;
 
+	/* Nothing to do if the same package has already been indexed */
+	if (toc_index.valid && (toc_index.image_id == image_id))
+		return 0;
+
+	toc_index_reset();
+
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
 				       &backend_image_spec);
@@ -168,16 +334,45 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 
 	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
 			&bytes_read);
-	if (result == 0) {
-		if (!is_valid_header(&header)) {
-			WARN("Firmware Image Package header check failed.\n");
-			result = -ENOENT;
-		} else {
-			VERBOSE("FIP header looks OK.\n");
+	if (result != 0)
+		goto fip_dev_init_close;
+
+	if (!is_valid_header(&header)) {
+		WARN("Firmware Image Package header check failed.\n");
+		result = -ENOENT;
+		goto fip_dev_init_close;
+	}
+	VERBOSE("FIP header looks OK.\n");
+	if (TOC_FLAGS_ALIGN(header.flags) > 1)
+		VERBOSE("FIP payloads are aligned to %u bytes.\n",
+			(unsigned int)TOC_FLAGS_ALIGN(header.flags));
+
+	/* The ToC follows the header and ends with a null UUID entry */
+	toc_index.complete = 1;
+	for (;;) {
+		result = io_read(backend_handle, (uintptr_t)&entry,
+				 sizeof(entry), &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read FIP (%i)\n", result);
+			goto fip_dev_init_close;
+		}
+		if (compare_uuids(&entry.uuid, &uuid_null) == 0)
+			break;
+		if (toc_index_add(&entry) != 0) {
+			WARN("FIP ToC exceeds %u entries, not indexed\n",
+			     FIP_MAX_TOC_ENTRIES);
+			toc_index.complete = 0;
+			break;
 		}
 	}
 
+	toc_index.valid = 1;
+	toc_index.image_id = image_id;
+
+ fip_dev_init_close:
 	io_close(backend_handle);
+	if (result != 0)
+		toc_index_reset();
 
  fip_dev_init_exit:
 	return result;
@@ -188,6 +383,9 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 {
 	/* TODO: Consider tracking open files and cleaning them up here */
 
+	/* Forget the ToC index. */
+	toc_index_reset();
+
 	/* Clear the backend. */
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
@@ -196,15 +394,55 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 }
 
 
+/*
+ * Get the size of a compressed file from the header at the start of its
+ * payload. Compressed payloads can only be read if FIP_LZ4 is enabled.
+ */
+static int fip_file_open_compressed(file_state_t *fp)
+{
+#if FIP_LZ4
+	fip_compressed_header_t header;
+	size_t bytes_read;
+	int result;
+
+	if (TOC_FLAGS_COMPRESSION(fp->entry.flags) != TOC_COMPRESSION_LZ4) {
+		WARN("Unsupported FIP payload compression\n");
+		return -ENOTSUP;
+	}
+
+	if (fp->entry.size < sizeof(header))
+		return -ENOENT;
+
+	result = io_seek(fp->backend_handle, IO_SEEK_SET,
+			 fp->entry.offset_address);
+	if (result != 0) {
+		WARN("fip_file_open: failed to seek\n");
+		return -ENOENT;
+	}
+
+	result = io_read(fp->backend_handle, (uintptr_t)&header,
+			 sizeof(header), &bytes_read);
+	if ((result != 0) || (bytes_read != sizeof(header))) {
+		WARN("Failed to read FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	fp->size = header.size;
+	return 0;
+#else
+	WARN("Compressed FIP payloads require FIP_LZ4=1\n");
+	return -ENOTSUP;
+#endif
+}
+
+
 /* Open a file for access from package. */
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
 	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_toc_entry_t *entry;
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
@@ -220,42 +458,39 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENOMEM;
 	}
 
+	if (!toc_index.valid) {
+		WARN("Firmware Image Package not initialised\n");
+		return -ENOENT;
+	}
+
+	entry = toc_index_find(&uuid_spec->uuid);
+	if ((entry == NULL) && toc_index.complete)
+		return -ENOENT;
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+			 &current_file.backend_handle);
 	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+		WARN("Failed to access FIP (%i)\n", result);
+		current_file.backend_handle = (uintptr_t)NULL;
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
-	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
+	if (entry != NULL) {
+		current_file.entry = *entry;
+	} else {
+		result = toc_scan(current_file.backend_handle,
+				  &uuid_spec->uuid, &current_file.entry);
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-				break;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
+	if (result == 0) {
+		current_file.size = current_file.entry.size;
+		if (TOC_FLAGS_COMPRESSION(current_file.entry.flags) !=
+		    TOC_COMPRESSION_NONE)
+			result = fip_file_open_compressed(&current_file);
+	}
 
-	if (found_file == 1) {
+	if (result == 0) {
 		/* All fine. Update entity info with file state and return. Set
 		 * the file position to 0. The 'current_file.entry' holds the
 		 * base and size of the file.
@@ -264,14 +499,11 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		entity->info = (uintptr_t)&current_file;
 	} else {
 		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
+		io_close(current_file.backend_handle);
+		memset(&current_file, 0, sizeof(current_file));
 		result = -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
-
- fip_file_open_exit:
 	return result;
 }
 
@@ -282,12 +514,88 @@ static int fip_file_len(io_entity_t *entity, size_t *length)
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	*length =  ((file_state_t *)entity->info)->entry.size;
+	*length =  ((file_state_t *)entity->info)->size;
 
 	return 0;
 }
 
 
+#if FIP_LZ4
+/*
+ * Read data from a compressed file. The payload is read through fip_lz4_buf
+ * and decompressed straight into the destination. Since matches are copied
+ * from the data already decompressed, the file must be read from its start
+ * into a contiguous destination, which is what load_image() does.
+ */
+static int fip_file_read_lz4(file_state_t *fp, uintptr_t buffer,
+			     size_t length, size_t *length_read)
+{
+	int result;
+	uintptr_t end;
+	size_t bytes_read, consumed;
+
+	if (fp->file_pos == 0) {
+		lz4_stream_init(&fp->lz4, buffer);
+		fp->src_pos = 0;
+		fp->src_off = 0;
+		fp->src_len = 0;
+	} else if (buffer != (uintptr_t)fp->lz4.out) {
+		WARN("fip_file_read: compressed file read out of order\n");
+		return -EINVAL;
+	}
+
+	if (length > fp->size - fp->file_pos)
+		length = fp->size - fp->file_pos;
+	end = buffer + length;
+
+	while ((uintptr_t)fp->lz4.out < end) {
+		if (fp->src_off == fp->src_len) {
+			/* Read the next part of the payload */
+			bytes_read = fp->entry.size - fp->src_pos;
+			if (bytes_read == 0)
+				break;
+			if (bytes_read > sizeof(fip_lz4_buf))
+				bytes_read = sizeof(fip_lz4_buf);
+
+			result = io_seek(fp->backend_handle, IO_SEEK_SET,
+					 fp->entry.offset_address + fp->src_pos);
+			if (result == 0)
+				result = io_read(fp->backend_handle,
+						 (uintptr_t)fip_lz4_buf,
+						 bytes_read, &bytes_read);
+			if ((result != 0) || (bytes_read == 0)) {
+				WARN("Failed to read payload (%i)\n", result);
+				return -ENOENT;
+			}
+
+			/* Skip the header at the start of the payload */
+			fp->src_off = (fp->src_pos == 0) ?
+				sizeof(fip_compressed_header_t) : 0;
+			fp->src_len = bytes_read;
+			fp->src_pos += bytes_read;
+			if (fp->src_off > fp->src_len)
+				return -ENOENT;
+		}
+
+		result = lz4_stream_decompress(&fp->lz4,
+					       fip_lz4_buf + fp->src_off,
+					       fp->src_len - fp->src_off,
+					       end, &consumed);
+		fp->src_off += consumed;
+		if (result != 0) {
+			WARN("Corrupted compressed payload\n");
+			return result;
+		}
+	}
+
+	*length_read = (uintptr_t)fp->lz4.out - buffer;
+	fp->file_pos += *length_read;
+
+	return 0;
+}
+#endif
+
+
 /* Read data from a file in package */
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read)
@@ -296,61 +604,109 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	file_state_t *fp;
 	size_t file_offset;
 	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	fp = (file_state_t *)entity->info;
+	assert(fp->backend_handle != (uintptr_t)NULL);
+
+#if FIP_LZ4
+	if (TOC_FLAGS_COMPRESSION(fp->entry.flags) != TOC_COMPRESSION_NONE)
+		return fip_file_read_lz4(fp, buffer, length, length_read);
+#endif
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(fp->backend_handle, IO_SEEK_SET, file_offset);
 	if (result != 0) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
+		WARN("fip_file_read: failed to seek\n");
+		return -ENOENT;
+	}
+
+	result = io_read(fp->backend_handle, buffer, length, &bytes_read);
+	if (result != 0) {
+		/* We cannot read our data. Fail. */
+		WARN("Failed to read payload (%i)\n", result);
+		return -ENOENT;
 	}
 
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
+
+	return 0;
+}
+
+
+/*
+ * Start reading data from a file in package. Returns -ENODEV if the backend
+ * cannot read asynchronously, or if the payload is compressed, in which case
+ * it is decompressed by synchronous reads.
+ */
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length)
+{
+	int result;
+	file_state_t *fp;
+	size_t file_offset;
+
+	assert(entity != NULL);
+	assert(buffer != (uintptr_t)NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
 	fp = (file_state_t *)entity->info;
+	assert(fp->backend_handle != (uintptr_t)NULL);
+
+	if (TOC_FLAGS_COMPRESSION(fp->entry.flags) != TOC_COMPRESSION_NONE)
+		return -ENODEV;
 
 	/* Seek to the position in the FIP where the payload lives */
 	file_offset = fp->entry.offset_address + fp->file_pos;
-	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+	result = io_seek(fp->backend_handle, IO_SEEK_SET, file_offset);
 	if (result != 0) {
-		WARN("fip_file_read: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_read_close;
+		WARN("fip_file_read_start: failed to seek\n");
+		return -ENOENT;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	return io_read_start(fp->backend_handle, buffer, length);
+}
+
+
+/* Wait for a read started by fip_file_read_start() */
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	result = io_read_wait(fp->backend_handle, length_read);
 	if (result != 0) {
-		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		return -ENOENT;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	fp->file_pos += *length_read;
 
- fip_file_read_exit:
-	return result;
+	return 0;
 }
 
 
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
+	/* Release the backend and clear our current file pointer.
 	 * If we had malloc() we would free() here.
 	 */
 	if (current_file.entry.offset_address != 0) {
+		io_close(current_file.backend_handle);
 		memset(&current_file, 0, sizeof(current_file));
 	}
 
@@ -356,3 +356,40 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+/* Asynchronous operations */
+
+
+/* Start reading data from an IO entity without waiting for completion */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->read_start != NULL)
+		result = dev->funcs->read_start(entity, buffer, length);
+
+	return result;
+}
+
+
+/* Wait for the read started by io_read_start() to complete */
+int io_read_wait(uintptr_t handle, size_t *length_read)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->read_wait != NULL)
+		result = dev->funcs->read_wait(entity, length_read);
+
+	return result;
+}
@@ -115,6 +115,52 @@
 #define get_interrupt_src_ss(flag)	((flag >> INTR_SRC_SS_FLAG_SHIFT) & \
 					 INTR_SRC_SS_FLAG_MASK)
 
+/*******************************************************************************
+ * Constants for the 'flags' parameter passed while registering a handler for an
+ * individual interrupt ID. INTR_ID_FLAG_FAST requests that the handler be called
+ * without saving the callee saved registers and the EL3 state of the
+ * interrupted context (see register_interrupt_handler()).
+ ******************************************************************************/
+#define INTR_ID_FLAG_FAST_SHIFT		0
+#define INTR_ID_FLAG_FAST		(1 << INTR_ID_FLAG_FAST_SHIFT)
+#define INTR_ID_FLAGS_MASK		(~INTR_ID_FLAG_FAST)
+
+/* Mask of the interrupt ID in the value of plat_ic_acknowledge_interrupt() */
+#define INTR_ID_RAW_MASK		0x3ff
+
+/* Acknowledging an interrupt returns an ID from this value up if it failed */
+#define INTR_ID_SPECIAL_MIN		1020
+
+/* Interrupt IDs below this value are software generated interrupts */
+#define INTR_ID_SGI_LIMIT		16
+
+/* Layout of the descriptors of the interrupt ID handlers */
+#define INTR_ID_DESC_HANDLER		0x0
+#define INTR_ID_DESC_FLAGS		0x8
+#define INTR_ID_DESC_SIZE_LOG2		4
+
+#if EL3_INTR_ID_DISPATCH
+#include <platform_def.h>
+
+/*
+ * Interrupt IDs below this value can have their own handler. By default, this
+ * covers the SGIs and PPIs.
+ */
+#ifndef PLAT_EL3_INTR_ID_LIMIT
+#define PLAT_EL3_INTR_ID_LIMIT		32
+#endif
+
+/*
+ * Only the Group 0 interrupts, which plat_ic_acknowledge_interrupt() can
+ * acknowledge at EL3, can have their own handler. This is the type that
+ * plat_ic_get_interrupt_type() reports for them. A GICv2 platform, which
+ * reports them as INTR_TYPE_S_EL1, must override it.
+ */
+#ifndef PLAT_EL3_INTR_ID_TYPE
+#define PLAT_EL3_INTR_ID_TYPE		INTR_TYPE_EL3
+#endif
+#endif
+
 #ifndef __ASSEMBLY__
 
 /* Prototype for defining a handler for an interrupt type */
@@ -134,6 +180,16 @@ int32_t register_interrupt_type_handler(uint32_t type,
 interrupt_type_handler_t get_interrupt_type_handler(uint32_t interrupt_type);
 int disable_intr_rm_local(uint32_t type, uint32_t security_state);
 int enable_intr_rm_local(uint32_t type, uint32_t security_state);
+#if EL3_INTR_ID_DISPATCH
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags);
+interrupt_type_handler_t get_interrupt_handler(uint32_t id);
+uint64_t dispatch_acked_interrupt(uint32_t id,
+				  uint32_t flags,
+				  void *handle,
+				  void *cookie);
+#endif
 
 #endif /*__ASSEMBLY__*/
 #endif /* __INTERRUPT_MGMT_H__ */
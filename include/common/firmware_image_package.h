@@ -37,6 +37,38 @@
 /* This is used as a signature to validate the blob header */
 #define TOC_HEADER_NAME	0xAA640001
 
+/*
+ * Bits [5:0] of the ToC header flags hold the log2 of the alignment, relative
+ * to the start of the package, that every payload has at least. The same bits
+ * of the flags of a ToC entry hold the alignment requested for that payload.
+ */
+#define TOC_FLAGS_ALIGN_SHIFT	0
+#define TOC_FLAGS_ALIGN_MASK	0x3fULL
+#define TOC_FLAGS_ALIGN(flags)	\
+	(1ULL << (((flags) >> TOC_FLAGS_ALIGN_SHIFT) & TOC_FLAGS_ALIGN_MASK))
+
+/*
+ * Bits [11:8] of the flags of a ToC entry tell how its payload is compressed.
+ * A compressed payload starts with a fip_compressed_header_t, followed by the
+ * compressed data. The size in the ToC entry is that of the whole payload.
+ */
+#define TOC_FLAGS_COMPRESSION_SHIFT	8
+#define TOC_FLAGS_COMPRESSION_MASK	0xfULL
+#define TOC_FLAGS_COMPRESSION(flags)	\
+	(((flags) >> TOC_FLAGS_COMPRESSION_SHIFT) & TOC_FLAGS_COMPRESSION_MASK)
+
+#define TOC_COMPRESSION_NONE		0
+/* A single LZ4 block, without the LZ4 frame around it */
+#define TOC_COMPRESSION_LZ4		1
+
+/*
+ * Bit 12 of the flags of a ToC entry is set when compression was requested for
+ * its payload, even if the payload is stored as is because it would not have
+ * got smaller. fiptool compresses the images that replace it in turn.
+ */
+#define TOC_FLAGS_COMPRESS_REQ_SHIFT	12
+#define TOC_FLAGS_COMPRESS_REQ		(1ULL << TOC_FLAGS_COMPRESS_REQ_SHIFT)
+
 
 /* ToC Entry UUIDs */
 #define UUID_TRUSTED_UPDATE_FIRMWARE_SCP_BL2U \
@@ -97,4 +129,9 @@ typedef struct fip_toc_entry {
 	uint64_t	flags;
 } fip_toc_entry_t;
 
+typedef struct fip_compressed_header {
+	/* Size of the payload once decompressed */
+	uint64_t	size;
+} fip_compressed_header_t;
+
 #endif /* __FIRMWARE_IMAGE_PACKAGE_H__ */
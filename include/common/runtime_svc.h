@@ -54,6 +54,43 @@
 #endif /* AARCH32 */
 #define SIZEOF_RT_SVC_DESC	(1 << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access the per function id dispatch table
+ * built from the 'rt_svc_fid_descs' by runtime_svc_init()
+ */
+#ifdef AARCH32
+#define RT_SVC_FID_ENTRY_SIZE_LOG2	3
+#define RT_SVC_FID_ENTRY_HANDLE		4
+#else
+#define RT_SVC_FID_ENTRY_SIZE_LOG2	4
+#define RT_SVC_FID_ENTRY_HANDLE		8
+#endif /* AARCH32 */
+#define RT_SVC_FID_ENTRY_FID		0
+#define SIZEOF_RT_SVC_FID_ENTRY		(1 << RT_SVC_FID_ENTRY_SIZE_LOG2)
+
+/*
+ * Number of slots in the per function id dispatch table. It must be a power
+ * of two and is kept at least twice the number of registered function ids so
+ * that lookups terminate quickly on an empty slot.
+ */
+#define RT_SVC_FID_TABLE_LOG2		6
+#define RT_SVC_FID_TABLE_SIZE		(1 << RT_SVC_FID_TABLE_LOG2)
+
+/* Function id marking an empty slot. It has the MBZ bits [23:16] set */
+#define RT_SVC_FID_INVALID		0xffffffff
+
+/* Whether the time spent handling each SMC is measured */
+#define RT_SVC_ACCOUNTING		(RT_SVC_FID_STATS || ENABLE_SMC_HIST)
+
+/*
+ * Hash of a function id into the dispatch table. The call type, calling
+ * convention and the low OEN bits are folded onto the function number so that
+ * the SMC32 and SMC64 flavours of a call land in different slots. The
+ * assembler version in runtime_exceptions.S must match.
+ */
+#define RT_SVC_FID_HASH(fid)		(((fid) ^ ((fid) >> 26)) & \
+						(RT_SVC_FID_TABLE_SIZE - 1))
+
 
 /*
  * The function identifier has 6 bits for the owning entity number and
@@ -103,6 +140,49 @@ typedef struct rt_svc_desc {
 			.init = _setup, \
 			.handle = _smch }
 
+/*
+ * Descriptor for a handler serving a single SMC function id. Services can
+ * export these in addition to their 'rt_svc_desc_t' so that frequently used
+ * calls are dispatched straight to their handler, without going through the
+ * owning entity lookup and the service's own switch on the function id. The
+ * handler is only installed if the service owning the function id has been
+ * registered and initialised successfully.
+ */
+typedef struct rt_svc_fid_desc {
+	uint32_t fid;
+	const char *name;
+	rt_svc_handle_t handle;
+} rt_svc_fid_desc_t;
+
+/*
+ * Convenience macro to declare a per function id handler descriptor
+ */
+#define DECLARE_RT_SVC_FID(_name, _fid, _smch) \
+	static const rt_svc_fid_desc_t __svc_fid_desc_ ## _name \
+		__section("rt_svc_fid_descs") __used = { \
+			.fid = _fid, \
+			.name = #_name, \
+			.handle = _smch }
+
+/*
+ * Entry of the per function id dispatch table
+ */
+typedef struct rt_svc_fid_entry {
+	uint32_t fid;
+	rt_svc_handle_t handle;
+} rt_svc_fid_entry_t;
+
+/*
+ * Per-cpu statistics collected for each entry of the per function id
+ * dispatch table when RT_SVC_FID_STATS is enabled. Time is expressed in
+ * system counter ticks.
+ */
+typedef struct rt_svc_fid_stats {
+	uint64_t count;
+	uint64_t total_ticks;
+	uint64_t max_ticks;
+} rt_svc_fid_stats_t;
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -119,6 +199,18 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+/*
+ * Compile time assertions ensuring that the assembler and the compiler agree
+ * on the layout of the 'rt_svc_fid_entry' structure.
+ */
+CASSERT((sizeof(rt_svc_fid_entry_t) == SIZEOF_RT_SVC_FID_ENTRY), \
+	assert_sizeof_rt_svc_fid_entry_mismatch);
+CASSERT(RT_SVC_FID_ENTRY_FID == __builtin_offsetof(rt_svc_fid_entry_t, fid), \
+	assert_rt_svc_fid_entry_fid_offset_mismatch);
+CASSERT(RT_SVC_FID_ENTRY_HANDLE == \
+	__builtin_offsetof(rt_svc_fid_entry_t, handle), \
+	assert_rt_svc_fid_entry_handle_offset_mismatch);
+
 
 /*
  * This macro combines the call type and the owning entity number corresponding
@@ -148,6 +240,17 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 extern uintptr_t __RT_SVC_DESCS_START__;
 extern uintptr_t __RT_SVC_DESCS_END__;
+extern uintptr_t __RT_SVC_FID_DESCS_START__;
+extern uintptr_t __RT_SVC_FID_DESCS_END__;
+extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
+int rt_svc_fid_lookup(uint32_t smc_fid);
+#if RT_SVC_ACCOUNTING
+void rt_svc_account(uint32_t smc_fid, unsigned int index, uint64_t ticks);
+#endif
+#if RT_SVC_FID_STATS
+int rt_svc_fid_get_stats(uint32_t smc_fid, unsigned int cpu_idx,
+			 rt_svc_fid_stats_t *stats);
+#endif
 void init_crash_reporting(void);
 
 #endif /*__ASSEMBLY__*/
@@ -38,6 +38,7 @@
 #define MIN_SGI_ID		0
 #define MIN_PPI_ID		16
 #define MIN_SPI_ID		32
+#define MAX_SPI_ID		1019
 
 /* Mask for the priority field common to all GIC interfaces */
 #define GIC_PRI_MASK			0xff
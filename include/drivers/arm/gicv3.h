@@ -253,6 +253,43 @@ typedef struct gicv3_driver_data {
 	mpidr_hash_fn mpidr_to_core_pos;
 } gicv3_driver_data_t;
 
+/*******************************************************************************
+ * These structures hold the GIC state saved across a power down of the GIC,
+ * e.g. during system suspend. Their memory has to be allocated by the platform
+ * port.
+ *
+ * The state of each block of 32 interrupt IDs is held in a
+ * 'gicv3_intr_block_ctx_t'. Only the registers which do not hold their reset
+ * value are saved, packed in the 'regs' array. Bit 'n' of 'reg_map' is set
+ * when the n-th register of the block has been saved. The Distributor context
+ * holds one such block for each implemented group of 32 SPIs. It also holds
+ * the routing of the SPIs whose IROUTER register is not 0, its reset value,
+ * indexed by SPI, with bit 'n' of 'irouter_map[b]' set when the routing of SPI
+ * 32 * (b + 1) + n has been saved. The Redistributor context holds the SGI/PPI block of a CPU.
+ ******************************************************************************/
+/* Number of 32-interrupt blocks needed to cover all the SPIs */
+#define GICV3_SPI_BLOCKS	31
+
+/* Number of 32-bit registers describing a block of 32 interrupt IDs */
+#define GICV3_INTR_BLOCK_REGS	17
+
+typedef struct gicv3_intr_block_ctx {
+	unsigned int reg_map;
+	unsigned int regs[GICV3_INTR_BLOCK_REGS];
+} gicv3_intr_block_ctx_t;
+
+typedef struct gicv3_dist_ctx {
+	unsigned int gicd_ctlr;
+	unsigned int num_ints;
+	gicv3_intr_block_ctx_t spi_blocks[GICV3_SPI_BLOCKS];
+	unsigned int irouter_map[GICV3_SPI_BLOCKS];
+	unsigned long long irouter[GICV3_SPI_BLOCKS << 5];
+} gicv3_dist_ctx_t;
+
+typedef struct gicv3_redist_ctx {
+	gicv3_intr_block_ctx_t ppi_sgi_block;
+} gicv3_redist_ctx_t;
+
 /*******************************************************************************
  * GICv3 EL3 driver API
  ******************************************************************************/
@@ -265,6 +302,12 @@ unsigned int gicv3_get_pending_interrupt_type(void);
 unsigned int gicv3_get_pending_interrupt_id(void);
 unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num);
+void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx);
+void gicv3_distif_restore(const gicv3_dist_ctx_t * const dist_ctx);
+void gicv3_rdistif_save(unsigned int proc_num,
+			gicv3_redist_ctx_t * const rdist_ctx);
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t * const rdist_ctx);
 
 
 #endif /* __ASSEMBLY__ */
@@ -60,6 +60,8 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_img_start(unsigned int img_id);
+void auth_mod_hash_img_update(void *data_ptr, unsigned int data_len);
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t */
 #define REGISTER_COT(_cot) \
@@ -61,6 +61,16 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Verify a hash incrementally. verify_hash_init() takes the expected
+	 * hash, verify_hash_update() is called for each block of data and
+	 * verify_hash_final() compares the result. Only one computation may
+	 * be in progress at a time. These functions are optional and return
+	 * one of the 'enum crypto_ret_value' options */
+	int (*verify_hash_init)(void *digest_info_ptr,
+				unsigned int digest_info_len);
+	int (*verify_hash_update)(void *data_ptr, unsigned int data_len);
+	int (*verify_hash_final)(void);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -71,6 +81,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len);
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_verify_hash_final(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -81,4 +95,18 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library supporting incremental hashing */
+#define REGISTER_CRYPTO_LIB_HASH_STREAM(_name, _init, _verify_signature, \
+		_verify_hash, _verify_hash_init, _verify_hash_update, \
+		_verify_hash_final) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.verify_hash_init = _verify_hash_init, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_final = _verify_hash_final \
+	}
+
 #endif /* __CRYPTO_MOD_H__ */
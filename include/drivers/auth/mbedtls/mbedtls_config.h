@@ -36,6 +36,11 @@
 #define MBEDTLS_RSA			1
 #define MBEDTLS_ECDSA			2
 
+/*
+ * Hash accelerators
+ */
+#include <mbedtls_sha256_accel.h>
+
 /*
  * Configuration file to build mbed TLS with the required features for
  * Trusted Boot
@@ -78,6 +83,10 @@
 #endif
 
 #define MBEDTLS_SHA256_C
+#if (MBEDTLS_HASH_ACCEL_ID != MBEDTLS_HASH_ACCEL_NONE)
+/* SHA-256 provided by drivers/auth/mbedtls/mbedtls_sha256_accel.c */
+#define MBEDTLS_SHA256_ALT
+#endif
 
 #define MBEDTLS_VERSION_C
 
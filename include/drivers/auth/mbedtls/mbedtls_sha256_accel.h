@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MBEDTLS_SHA256_ACCEL_H__
+#define __MBEDTLS_SHA256_ACCEL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Hash accelerators that may replace the mbed TLS SHA-256 block function,
+ * selected with MBEDTLS_HASH_ACCEL at build time
+ */
+#define MBEDTLS_HASH_ACCEL_NONE		0
+#define MBEDTLS_HASH_ACCEL_ARMV8_CE	1
+
+#ifndef __ASSEMBLY__
+/* SHA-256 round constants */
+extern const uint32_t sha256_k[64];
+
+/* Process 'blocks' 64-byte blocks using the ARMv8 Crypto Extensions */
+void sha256_armv8_ce_process(uint32_t state[8], const unsigned char *data,
+			     size_t blocks);
+#endif
+
+#endif /* __MBEDTLS_SHA256_ACCEL_H__ */
@@ -175,6 +175,8 @@ typedef struct emmc_csd {
 } emmc_csd_t;
 
 size_t emmc_read_blocks(int lba, uintptr_t buf, size_t size);
+int emmc_read_blocks_start(int lba, uintptr_t buf, size_t size);
+size_t emmc_read_blocks_wait(void);
 size_t emmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t emmc_erase_blocks(int lba, size_t size);
 size_t emmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
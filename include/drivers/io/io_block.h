@@ -37,12 +37,26 @@
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional. read_start() queues a read of whole blocks, usually by
+	 * DMA, and returns 0 without waiting for it. read_wait() waits for it
+	 * and returns the number of bytes read. Reads larger than
+	 * max_read_size are done with read() instead.
+	 */
+	int	(*read_start)(int lba, uintptr_t buf, size_t size);
+	size_t	(*read_wait)(void);
 } io_block_ops_t;
 
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Largest number of bytes passed to a single read() or read_start(),
+	 * a multiple of block_size. Larger reads are split into requests of
+	 * this size. 0 limits the requests to the length of the buffer.
+	 */
+	size_t		max_read_size;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -72,6 +72,13 @@ typedef struct io_dev_funcs {
 	int (*close)(io_entity_t *entity);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
+	/*
+	 * Optional asynchronous read. read_start() queues a read and returns
+	 * without waiting for it; read_wait() blocks until it has completed.
+	 * Only one read may be outstanding per entity.
+	 */
+	int (*read_start)(io_entity_t *entity, uintptr_t buffer, size_t length);
+	int (*read_wait)(io_entity_t *entity, size_t *length_read);
 } io_dev_funcs_t;
 
 
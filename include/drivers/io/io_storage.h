@@ -123,4 +123,10 @@ int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 int io_close(uintptr_t handle);
 
 
+/* Asynchronous operations, -ENODEV if the device only supports io_read() */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length);
+
+int io_read_wait(uintptr_t handle, size_t *length_read);
+
+
 #endif /* __IO_H__ */
@@ -80,7 +80,16 @@
 #define CTX_RUNTIME_SP		0x8
 #define CTX_SPSR_EL3		0x10
 #define CTX_ELR_EL3		0x18
+#if CTX_INCLUDE_FPREGS
+/*
+ * Non-zero when the FP/SIMD registers of the CPU hold the state of this
+ * context rather than its 'fp_regs' structure.
+ */
+#define CTX_FPREGS_LIVE		0x20
+#define CTX_EL3STATE_END	0x30 /* Align to the next 16 byte boundary */
+#else
 #define CTX_EL3STATE_END	0x20
+#endif
 
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
@@ -144,6 +153,27 @@
 #define CTX_SYSREGS_END		CTX_TIMER_SYSREGS_OFF
 #endif /* __NS_TIMER_SWITCH__ */
 
+/*
+ * Groups of EL1 system registers which a world switch may leave in the
+ * hardware when the secure payload does not modify them. The registers not
+ * listed here are always saved and restored, as are the NS timer registers
+ * when NS_TIMER_SWITCH is set.
+ *
+ * CTX_EL1_REGS_EL0_TID	: TPIDR_EL0, TPIDRRO_EL0
+ * CTX_EL1_REGS_FAULT	: ESR_EL1, FAR_EL1, PAR_EL1, AFSR0_EL1, AFSR1_EL1
+ * CTX_EL1_REGS_AARCH32	: SPSR_{ABT,UND,IRQ,FIQ}, DACR32_EL2, IFSR32_EL2,
+ *			  FPEXC32_EL2. Ignored if CTX_INCLUDE_AARCH32_REGS is 0
+ */
+#define CTX_EL1_REGS_EL0_TID_SHIFT	0
+#define CTX_EL1_REGS_FAULT_SHIFT	1
+#define CTX_EL1_REGS_AARCH32_SHIFT	2
+#define CTX_EL1_REGS_EL0_TID	(1 << CTX_EL1_REGS_EL0_TID_SHIFT)
+#define CTX_EL1_REGS_FAULT	(1 << CTX_EL1_REGS_FAULT_SHIFT)
+#define CTX_EL1_REGS_AARCH32	(1 << CTX_EL1_REGS_AARCH32_SHIFT)
+#define CTX_EL1_REGS_MIN	0
+#define CTX_EL1_REGS_ALL	(CTX_EL1_REGS_EL0_TID | CTX_EL1_REGS_FAULT | \
+				 CTX_EL1_REGS_AARCH32)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
  * structure at their correct offsets.
@@ -331,8 +361,8 @@ CASSERT(CTX_EL3STATE_OFFSET == __builtin_offsetof(cpu_context_t, el3state_ctx),
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
-void el1_sysregs_context_save(el1_sys_regs_t *regs);
-void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_save(el1_sys_regs_t *regs, unsigned int groups);
+void el1_sysregs_context_restore(el1_sys_regs_t *regs, unsigned int groups);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
@@ -57,6 +57,7 @@ void cm_prepare_el3_exit(uint32_t security_state);
 #ifndef AARCH32
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
+void cm_set_el1_sysregs_switch_groups(unsigned int groups);
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
 			uintptr_t entrypoint, uint32_t spsr);
@@ -65,6 +66,9 @@ void cm_write_scr_el3_bit(uint32_t security_state,
 			  uint32_t value);
 void cm_set_next_eret_context(uint32_t security_state);
 uint32_t cm_get_scr_el3(uint32_t security_state);
+#if CTX_INCLUDE_FPREGS
+void cm_fpregs_context_flush(void);
+#endif
 
 
 void cm_init_context(uint64_t mpidr,
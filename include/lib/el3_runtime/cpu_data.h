@@ -41,6 +41,7 @@
 #else /* AARCH32 */
 
 /* Offsets for the cpu_data structure */
+#define CPU_DATA_CONTEXT_OFFSET		0x0
 #define CPU_DATA_CRASH_BUF_OFFSET	0x18
 /* need enough space in crash buffer to save 8 registers */
 #define CPU_DATA_CRASH_BUF_SIZE		64
@@ -125,6 +126,12 @@ CASSERT(CPU_DATA_CRASH_BUF_OFFSET == __builtin_offsetof
 CASSERT((1 << CPU_DATA_LOG2SIZE) == sizeof(cpu_data_t),
 	assert_cpu_data_log2size_mismatch);
 
+#ifndef AARCH32
+CASSERT(CPU_DATA_CONTEXT_OFFSET == __builtin_offsetof
+	(cpu_data_t, cpu_context),
+	assert_cpu_data_context_offset_mismatch);
+#endif
+
 CASSERT(CPU_DATA_CPU_OPS_PTR == __builtin_offsetof
 		(cpu_data_t, cpu_ops_ptr),
 		assert_cpu_data_cpu_ops_ptr_offset_mismatch);
@@ -135,6 +142,24 @@ CASSERT(CPU_DATA_PMF_TS0_OFFSET == __builtin_offsetof
 		assert_cpu_data_pmf_ts0_offset_mismatch);
 #endif
 
+/*******************************************************************************
+ * Helpers to lay out the per-cpu arrays kept outside of cpu_data_t, for the data
+ * which is written by its cpu and read by the others. The type of the entries
+ * is declared with `__per_cpu_aligned` so that each entry starts on a cache line
+ * and no two cpus write to the same line. DEFINE_PER_CPU_ARRAY() defines the
+ * array in the '.bss.per_cpu_data' section, which the linker script places at
+ * the start of .bss on a cache line boundary, and checks the alignment of the
+ * entries at build time. The '.bss.' prefix makes it a NOBITS section like the
+ * rest of .bss.
+ ******************************************************************************/
+#define __per_cpu_aligned	__aligned(CACHE_WRITEBACK_GRANULE)
+
+#define DEFINE_PER_CPU_ARRAY(_type, _name)				\
+	_type _name[PLATFORM_CORE_COUNT]				\
+		__section(".bss.per_cpu_data");				\
+	CASSERT((__alignof__(_type) & (CACHE_WRITEBACK_GRANULE - 1)) == 0, \
+		assert_##_name##_entry_not_cache_line_aligned)
+
 struct cpu_data *_cpu_data_by_index(uint32_t cpu_index);
 
 #ifndef AARCH32
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * State of the decompression of an LZ4 block. The input can be provided in
+ * pieces of any size and the output produced in pieces of any size, so that a
+ * large image can be decompressed straight to its destination through a small
+ * input buffer. The output must be contiguous, as matches are copied from the
+ * data already decompressed.
+ ******************************************************************************/
+typedef struct lz4_stream {
+	/* Start of the output and next byte to be written to it */
+	uint8_t		*out_base;
+	uint8_t		*out;
+	/* Bytes left in the current literal run or match */
+	size_t		count;
+	unsigned int	offset;
+	uint8_t		token;
+	uint8_t		state;
+} lz4_stream_t;
+
+void lz4_stream_init(lz4_stream_t *stream, uintptr_t out);
+int lz4_stream_decompress(lz4_stream_t *stream, const uint8_t *src,
+			  size_t src_len, uintptr_t out_end, size_t *consumed);
+
+#endif /* __LZ4_H__ */
@@ -63,7 +63,13 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	0x82000010
 #define PMF_SMC_GET_TIMESTAMP_64	0xC2000010
+#define PMF_SMC_GET_SMC_HIST_32		0x82000011
+#define PMF_SMC_GET_SMC_HIST_64		0xC2000011
+#if ENABLE_SMC_HIST
+#define PMF_NUM_SMC_CALLS		4
+#else
 #define PMF_NUM_SMC_CALLS		2
+#endif
 
 /*
  * The macros below are used to identify
@@ -76,6 +82,17 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_SMC_HIST_SVC_ID	2
+
+/*
+ * SMC latency histograms. Bucket 0 counts the SMCs handled in less than
+ * PMF_SMC_HIST_BASE_TICKS system counter ticks, bucket n the ones handled in
+ * [BASE << (2 * (n - 1)), BASE << (2 * n)) ticks. The last bucket is open
+ * ended.
+ */
+#define PMF_SMC_HIST_BUCKETS	8
+#define PMF_SMC_HIST_BASE_SHIFT	6
+#define PMF_SMC_HIST_BASE_TICKS	(1 << PMF_SMC_HIST_BASE_SHIFT)
 
 #if ENABLE_PMF
 /*
@@ -188,6 +205,15 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		unsigned int flags,
 		unsigned long long *ts);
 int pmf_setup(void);
+#if ENABLE_SMC_HIST
+void pmf_smc_hist_add_fid(unsigned int fid_index);
+void pmf_smc_hist_update(unsigned int smc_fid, unsigned int fid_index,
+		unsigned long long ticks);
+int pmf_get_smc_hist_smc(unsigned int smc_fid,
+		unsigned int bucket,
+		u_register_t mpidr,
+		unsigned long long *count);
+#endif
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
 		u_register_t x2,
@@ -363,6 +363,30 @@ void psci_entrypoint(void) __deprecated;
  */
 typedef void (*mailbox_entrypoint_t)(void);
 
+/******************************************************************************
+ * Layout of the buffer filled by psci_stat_get_all(). The header is followed
+ * by `num_states` entries for each cpu power domain, ordered by cpu index,
+ * and then by `num_states` entries for each non cpu power domain. Times are
+ * expressed in microseconds. The wake-up fields are only updated when
+ * PSCI_STAT_WAKEUP_LATENCY is enabled.
+ *****************************************************************************/
+#define PSCI_STAT_BUF_VERSION		1
+
+typedef struct psci_stat_buf_hdr {
+	uint32_t version;
+	uint32_t num_cpus;
+	uint32_t num_non_cpu_pds;
+	uint32_t num_states;
+} psci_stat_buf_hdr_t;
+
+typedef struct psci_stat_buf_entry {
+	uint64_t residency;
+	uint64_t count;
+	uint64_t wakeup_count;
+	uint64_t wakeup_total;
+	uint64_t wakeup_max;
+} psci_stat_buf_entry_t;
+
 /******************************************************************************
  * Structure to pass PSCI Library arguments.
  *****************************************************************************/
@@ -408,11 +432,22 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			  void *cookie,
 			  void *handle,
 			  u_register_t flags);
+u_register_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+			  u_register_t x1,
+			  u_register_t x2,
+			  u_register_t x3,
+			  u_register_t x4,
+			  void *cookie,
+			  void *handle,
+			  u_register_t flags);
 int psci_setup(const psci_lib_args_t *lib_args);
 void psci_warmboot_entrypoint(void);
 void psci_register_spd_pm_hook(const spd_pm_ops_t *pm);
 void psci_prepare_next_non_secure_ctx(
 			  entry_point_info_t *next_image_info);
+#if ENABLE_PSCI_STAT
+int psci_stat_get_all(void *buf, size_t size);
+#endif
 
 #endif /*__ASSEMBLY__*/
 
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TICKET_LOCK_H__
+#define __TICKET_LOCK_H__
+
+/*
+ * Fair lock granting the CPUs access in the order they asked for it. A CPU
+ * takes a ticket by incrementing 'next' and waits, in a low power state, until
+ * 'owner' reaches its ticket. Releasing the lock increments 'owner'.
+ *
+ * The lock is implemented with exclusive accesses, so like spinlocks it can
+ * only be used by CPUs that have their data cache enabled, unlike bakery
+ * locks.
+ */
+#define TICKET_LOCK_OWNER_SHIFT		0
+#define TICKET_LOCK_NEXT_SHIFT		16
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+
+typedef struct ticket_lock {
+	/* owner in bits [15:0], next in bits [31:16] */
+	volatile uint32_t lock;
+} ticket_lock_t;
+
+void ticket_lock_get(ticket_lock_t *lock);
+void ticket_lock_release(ticket_lock_t *lock);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __TICKET_LOCK_H__ */
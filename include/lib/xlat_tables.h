@@ -57,6 +57,13 @@
 #define PXN			(1ull << 1)
 #define CONT_HINT		(1ull << 0)
 
+/*
+ * Number of adjacent, aligned block or page descriptors which can share a
+ * single TLB entry when they all have CONT_HINT set
+ */
+#define XLAT_CONT_ENTRIES_SHIFT	4
+#define XLAT_CONT_ENTRIES	(1 << XLAT_CONT_ENTRIES_SHIFT)
+
 #define UPPER_ATTRS(x)		(x & 0x7) << 52
 #define NON_GLOBAL		(1 << 9)
 #define ACCESS_FLAG		(1 << 8)
@@ -194,6 +201,17 @@ void mmap_add_region(unsigned long long base_pa, uintptr_t base_va,
 				size_t size, unsigned int attr);
 void mmap_add(const mmap_region_t *mm);
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Runtime translation table API. A dynamic region can be added before or after
+ * init_xlat_tables() and removed at any time. It must not overlap any other
+ * region. These functions are not thread safe, the caller must serialize them.
+ */
+int mmap_add_dynamic_region(unsigned long long base_pa, uintptr_t base_va,
+				size_t size, unsigned int attr);
+int mmap_remove_dynamic_region(uintptr_t base_va, size_t size);
+#endif
+
 #ifdef AARCH32
 /* AArch32 specific translation table API */
 void enable_mmu_secure(uint32_t flags);
@@ -40,6 +40,11 @@
 #include <smcc_helpers.h>
 #include <string.h>
 
+/*
+ * Optional groups of EL1 system registers switched by
+ * cm_el1_sysregs_context_save() and cm_el1_sysregs_context_restore()
+ */
+static unsigned int el1_sysregs_switch_groups = CTX_EL1_REGS_ALL;
 
 /*******************************************************************************
  * Context management library initialisation routine. This library is used by
@@ -262,7 +267,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
 		}
 	}
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx), CTX_EL1_REGS_ALL);
 
 	cm_set_next_context(ctx);
 }
@@ -270,7 +275,8 @@ void cm_prepare_el3_exit(uint32_t security_state)
 /*******************************************************************************
  * The next four functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
- * state.
+ * state. Only the optional register groups selected through
+ * cm_set_el1_sysregs_switch_groups() are included.
  ******************************************************************************/
 void cm_el1_sysregs_context_save(uint32_t security_state)
 {
@@ -279,7 +285,8 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
-	el1_sysregs_context_save(get_sysregs_ctx(ctx));
+	el1_sysregs_context_save(get_sysregs_ctx(ctx),
+				 el1_sysregs_switch_groups);
 }
 
 void cm_el1_sysregs_context_restore(uint32_t security_state)
@@ -289,9 +296,65 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx),
+				    el1_sysregs_switch_groups);
+}
+
+/*******************************************************************************
+ * This function is used by a Secure payload dispatcher to declare which of the
+ * optional CTX_EL1_REGS_* groups of EL1 system registers its secure payload
+ * modifies. The other groups are left in the hardware when switching between
+ * the security states, so they always hold the non-secure values. This saves
+ * system register accesses on every world switch, e.g. for fast SMCs.
+ *
+ * A group must not be omitted if the secure payload writes any of its
+ * registers, directly or as a side effect (e.g. an exception taken to S-EL1
+ * updates ESR_EL1 and FAR_EL1), as that would corrupt the non-secure state and
+ * leak secure state to the normal world. It must be called during cold boot,
+ * before any world switch and before the secondary CPUs are powered on.
+ * cm_prepare_el3_exit() still restores the full set.
+ ******************************************************************************/
+void cm_set_el1_sysregs_switch_groups(unsigned int groups)
+{
+	assert((groups & ~CTX_EL1_REGS_ALL) == 0);
+
+	el1_sysregs_switch_groups = groups;
 }
 
+#if CTX_INCLUDE_FPREGS
+/*******************************************************************************
+ * BL31 switches the FP/SIMD state lazily, so the registers may hold the state
+ * of one of the contexts of this CPU instead of its 'fp_regs' structure. This
+ * function saves that state in its context. It must be called before the CPU
+ * is powered down, as the registers lose their contents. The state is loaded
+ * back when a lower EL next accesses the registers.
+ ******************************************************************************/
+void cm_fpregs_context_flush(void)
+{
+	cpu_context_t *ctx;
+	el3_state_t *state;
+	unsigned int security_state;
+
+	for (security_state = SECURE; security_state <= NON_SECURE;
+	     security_state++) {
+		ctx = cm_get_context(security_state);
+		if (ctx == NULL)
+			continue;
+
+		state = get_el3state_ctx(ctx);
+		if (read_ctx_reg(state, CTX_FPREGS_LIVE) == 0)
+			continue;
+
+		/* EL3 accesses to the FP/SIMD registers may be trapped */
+		write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+		isb();
+
+		fpregs_context_save(get_fpregs_ctx(ctx));
+		write_ctx_reg(state, CTX_FPREGS_LIVE, 0);
+	}
+}
+#endif
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
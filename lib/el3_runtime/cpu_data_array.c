@@ -33,4 +33,4 @@
 #include <platform_def.h>
 
 /* The per_cpu_ptr_cache_t space allocation */
-cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
+DEFINE_PER_CPU_ARRAY(cpu_data_t, percpu_data);
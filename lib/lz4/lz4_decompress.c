@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <lz4.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Streaming decoder for the LZ4 block format. A block is a series of sequences,
+ * each made of a token, the extra bytes of the literal length, the literals,
+ * a 16-bit little-endian match offset and the extra bytes of the match length.
+ * The last sequence only has literals, so the caller tells the end of the
+ * block from the size of the decompressed data.
+ ******************************************************************************/
+#define LZ4_MIN_MATCH		4
+#define LZ4_LEN_MASK		0xf
+
+enum {
+	LZ4_ST_TOKEN,
+	LZ4_ST_LIT_LEN,
+	LZ4_ST_LITERALS,
+	LZ4_ST_OFFSET_LO,
+	LZ4_ST_OFFSET_HI,
+	LZ4_ST_MATCH_LEN,
+	LZ4_ST_MATCH
+};
+
+void lz4_stream_init(lz4_stream_t *stream, uintptr_t out)
+{
+	memset(stream, 0, sizeof(*stream));
+	stream->out_base = (uint8_t *)out;
+	stream->out = (uint8_t *)out;
+	stream->state = LZ4_ST_TOKEN;
+}
+
+/*******************************************************************************
+ * Decompress from the 'src_len' bytes at 'src' until either all of them have
+ * been consumed or the output has reached 'out_end'. The number of input bytes
+ * consumed is returned in 'consumed' and the decompressed data ends at
+ * 'stream->out'. Returns 0 on success, or -EINVAL if a match refers to data
+ * before the start of the output.
+ ******************************************************************************/
+int lz4_stream_decompress(lz4_stream_t *stream, const uint8_t *src,
+			  size_t src_len, uintptr_t out_end, size_t *consumed)
+{
+	const uint8_t *in = src, *in_end = src + src_len;
+	uint8_t *out = stream->out, *end = (uint8_t *)out_end;
+	size_t count = stream->count, n;
+	int rc = 0;
+
+	while (out < end) {
+		/* Only the copy of a match does not need any more input */
+		if ((stream->state != LZ4_ST_MATCH) && (in == in_end))
+			break;
+
+		switch (stream->state) {
+		case LZ4_ST_TOKEN:
+			stream->token = *in++;
+			count = stream->token >> 4;
+			if (count == LZ4_LEN_MASK)
+				stream->state = LZ4_ST_LIT_LEN;
+			else if (count != 0)
+				stream->state = LZ4_ST_LITERALS;
+			else
+				stream->state = LZ4_ST_OFFSET_LO;
+			break;
+
+		case LZ4_ST_LIT_LEN:
+			count += *in;
+			if (*in++ != 0xff)
+				stream->state = LZ4_ST_LITERALS;
+			break;
+
+		case LZ4_ST_LITERALS:
+			n = count;
+			if (n > (size_t)(in_end - in))
+				n = in_end - in;
+			if (n > (size_t)(end - out))
+				n = end - out;
+			memcpy(out, in, n);
+			in += n;
+			out += n;
+			count -= n;
+			if (count == 0)
+				stream->state = LZ4_ST_OFFSET_LO;
+			break;
+
+		case LZ4_ST_OFFSET_LO:
+			stream->offset = *in++;
+			stream->state = LZ4_ST_OFFSET_HI;
+			break;
+
+		case LZ4_ST_OFFSET_HI:
+			stream->offset |= (unsigned int)*in++ << 8;
+			if ((stream->offset == 0) ||
+			    (stream->offset > (size_t)(out - stream->out_base))) {
+				rc = -EINVAL;
+				goto exit;
+			}
+			count = stream->token & LZ4_LEN_MASK;
+			if (count == LZ4_LEN_MASK) {
+				stream->state = LZ4_ST_MATCH_LEN;
+			} else {
+				count += LZ4_MIN_MATCH;
+				stream->state = LZ4_ST_MATCH;
+			}
+			break;
+
+		case LZ4_ST_MATCH_LEN:
+			count += *in;
+			if (*in++ != 0xff) {
+				count += LZ4_MIN_MATCH;
+				stream->state = LZ4_ST_MATCH;
+			}
+			break;
+
+		case LZ4_ST_MATCH:
+			n = count;
+			if (n > (size_t)(end - out))
+				n = end - out;
+			count -= n;
+			if (n <= stream->offset) {
+				memcpy(out, out - stream->offset, n);
+				out += n;
+			} else {
+				/* Overlapping copy, repeating the last bytes */
+				for (; n != 0; n--, out++)
+					*out = *(out - stream->offset);
+			}
+			if (count == 0)
+				stream->state = LZ4_ST_TOKEN;
+			break;
+
+		default:
+			rc = -EINVAL;
+			goto exit;
+		}
+	}
+
+exit:
+	stream->out = out;
+	stream->count = count;
+	*consumed = in - src;
+	return rc;
+}
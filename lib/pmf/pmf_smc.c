@@ -66,6 +66,19 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			SMC_RET3(handle, rc, (uint32_t)ts_value,
 					(uint32_t)(ts_value >> 32));
 
+#if ENABLE_SMC_HIST
+		case PMF_SMC_GET_SMC_HIST_32:
+			/*
+			 * Return error code and the number of SMCs in
+			 * the requested histogram bucket to the caller.
+			 * x0 --> error code.
+			 * x1 - x2 --> count.
+			 */
+			rc = pmf_get_smc_hist_smc(x1, x2, x3, &ts_value);
+			SMC_RET3(handle, rc, (uint32_t)ts_value,
+					(uint32_t)(ts_value >> 32));
+#endif
+
 		default:
 			break;
 		}
@@ -81,6 +94,18 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			rc = pmf_get_timestamp_smc(x1, x2, x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 
+#if ENABLE_SMC_HIST
+		case PMF_SMC_GET_SMC_HIST_64:
+			/*
+			 * Return error code and the number of SMCs in
+			 * the requested histogram bucket to the caller.
+			 * x0 --> error code.
+			 * x1 --> count.
+			 */
+			rc = pmf_get_smc_hist_smc(x1, x2, x3, &ts_value);
+			SMC_RET2(handle, rc, ts_value);
+#endif
+
 		default:
 			break;
 		}
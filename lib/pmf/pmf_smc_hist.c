@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <cassert.h>
+#include <cpu_data.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <runtime_svc.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Each cpu keeps one latency histogram per registered runtime service, indexed
+ * by the position of its descriptor in the 'rt_svc_descs' array, followed by
+ * one histogram per handler installed in the per function id dispatch table.
+ * Services and handlers beyond the number of rows configured by the platform
+ * share the last row of their kind. A histogram is only written by the owning
+ * cpu so no locking is needed, and the per-cpu blocks are cache line aligned
+ * to avoid false sharing.
+ ******************************************************************************/
+#ifndef PLAT_PMF_SMC_HIST_SVC_ROWS
+#define PLAT_PMF_SMC_HIST_SVC_ROWS	8
+#endif
+#ifndef PLAT_PMF_SMC_HIST_FID_ROWS
+#define PLAT_PMF_SMC_HIST_FID_ROWS	8
+#endif
+
+CASSERT((PLAT_PMF_SMC_HIST_SVC_ROWS > 0) && (PLAT_PMF_SMC_HIST_FID_ROWS > 0),
+	assert_pmf_smc_hist_rows);
+CASSERT(PLAT_PMF_SMC_HIST_FID_ROWS <= 256, assert_pmf_smc_hist_fid_rows);
+
+#define PMF_SMC_HIST_ROWS	(PLAT_PMF_SMC_HIST_SVC_ROWS + \
+				 PLAT_PMF_SMC_HIST_FID_ROWS)
+
+typedef struct pmf_smc_hist {
+	uint32_t count[PMF_SMC_HIST_ROWS][PMF_SMC_HIST_BUCKETS];
+} __per_cpu_aligned pmf_smc_hist_t;
+
+static DEFINE_PER_CPU_ARRAY(pmf_smc_hist_t, pmf_smc_hist);
+
+/* Histogram row of each slot of the per function id dispatch table */
+static uint8_t smc_hist_fid_rows[RT_SVC_FID_TABLE_SIZE];
+
+/*
+ * Allocate a histogram row to the handler installed in slot `fid_index` of the
+ * per function id dispatch table. Called by the runtime services framework
+ * while it builds the table during cold boot.
+ */
+void pmf_smc_hist_add_fid(unsigned int fid_index)
+{
+	static unsigned int num_fid_rows;
+
+	assert(fid_index < RT_SVC_FID_TABLE_SIZE);
+
+	if (num_fid_rows < PLAT_PMF_SMC_HIST_FID_ROWS)
+		smc_hist_fid_rows[fid_index] = num_fid_rows++;
+	else
+		smc_hist_fid_rows[fid_index] = PLAT_PMF_SMC_HIST_FID_ROWS - 1;
+}
+
+/*
+ * Return the histogram row used for `smc_fid`. `fid_index` is the index of the
+ * function id in the per function id dispatch table, or RT_SVC_FID_INVALID if
+ * the call is dispatched by owning entity.
+ */
+static unsigned int smc_hist_row(unsigned int smc_fid, unsigned int fid_index)
+{
+	unsigned int row;
+
+	if (fid_index < RT_SVC_FID_TABLE_SIZE)
+		return PLAT_PMF_SMC_HIST_SVC_ROWS + smc_hist_fid_rows[fid_index];
+
+	row = rt_svc_descs_indices[get_unique_oen_from_smc_fid(smc_fid)];
+	if (row >= PLAT_PMF_SMC_HIST_SVC_ROWS)
+		row = PLAT_PMF_SMC_HIST_SVC_ROWS - 1;
+
+	return row;
+}
+
+/*
+ * Return the histogram bucket of an SMC handled in `ticks` ticks.
+ */
+static unsigned int smc_hist_bucket(unsigned long long ticks)
+{
+	unsigned long long limit = PMF_SMC_HIST_BASE_TICKS;
+	unsigned int bucket = 0;
+
+	while ((bucket < (PMF_SMC_HIST_BUCKETS - 1)) && (ticks >= limit)) {
+		bucket++;
+		limit <<= 2;
+	}
+
+	return bucket;
+}
+
+/*
+ * Account an SMC handled by the calling cpu in `ticks` ticks. This is called
+ * by the runtime services framework on the way out of EL3.
+ */
+void pmf_smc_hist_update(unsigned int smc_fid, unsigned int fid_index,
+		unsigned long long ticks)
+{
+	unsigned int row = smc_hist_row(smc_fid, fid_index);
+
+	assert(row < PMF_SMC_HIST_ROWS);
+
+	pmf_smc_hist[plat_my_core_pos()].count[row][smc_hist_bucket(ticks)]++;
+}
+
+/*
+ * This function retrieves, for the cpu identified by `mpidr`, the number of
+ * SMCs handled within `bucket` that belong to the histogram of `smc_fid`: the
+ * function id itself if it has a handler in the per function id dispatch
+ * table, the runtime service owning it otherwise.
+ */
+int pmf_get_smc_hist_smc(unsigned int smc_fid,
+		unsigned int bucket,
+		u_register_t mpidr,
+		unsigned long long *count)
+{
+	int cpuid = plat_core_pos_by_mpidr(mpidr);
+	int fid_index;
+
+	assert(count);
+
+	if ((cpuid < 0) || (bucket >= PMF_SMC_HIST_BUCKETS)) {
+		*count = 0;
+		return -EINVAL;
+	}
+
+	fid_index = rt_svc_fid_lookup(smc_fid);
+	*count = pmf_smc_hist[cpuid].count[smc_hist_row(smc_fid,
+			(fid_index < 0) ? RT_SVC_FID_INVALID : fid_index)][bucket];
+
+	return 0;
+}
+
+/*
+ * PMF service time-stamp retrieval handler. The value returned for the
+ * time-stamp id `n` is the number of SMCs handled by the cpu identified by
+ * `mpidr` within bucket `n`, across all runtime services.
+ */
+static unsigned long long pmf_smc_hist_get_ts(unsigned int tid,
+		u_register_t mpidr,
+		unsigned int flags)
+{
+	int cpuid = plat_core_pos_by_mpidr(mpidr);
+	unsigned int bucket = tid & PMF_TID_MASK;
+	unsigned long long total = 0;
+	unsigned int row;
+
+	assert(cpuid >= 0);
+	assert(bucket < PMF_SMC_HIST_BUCKETS);
+
+	for (row = 0; row < PMF_SMC_HIST_ROWS; row++)
+		total += pmf_smc_hist[cpuid].count[row][bucket];
+
+	return total;
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(smc_hist, PMF_ARM_TIF_IMPL_ID,
+	PMF_SMC_HIST_SVC_ID, PMF_SMC_HIST_BUCKETS, NULL, pmf_smc_hist_get_ts)
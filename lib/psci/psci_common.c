@@ -64,6 +64,23 @@ const spd_pm_ops_t *psci_spd_pm;
 static plat_local_state_t
 	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
 
+#if PSCI_ATOMIC_COORDINATION
+/*
+ * Number of cpus in each power domain at level 1 which have requested it to
+ * be in the RUN state. It is updated with atomic operations whenever the
+ * requested local power state of a cpu for its parent moves in or out of RUN,
+ * so that a cpu can find out without taking any lock whether it is the last
+ * one to leave its parent running. Each counter is on its own cache line and
+ * lives in normal memory as exclusive accesses are not guaranteed to work on
+ * the coherent memory which may hold 'psci_non_cpu_pd_nodes'. Only the
+ * entries of the power domains at level 1 are used.
+ */
+static struct {
+	unsigned int count;
+} __aligned(CACHE_WRITEBACK_GRANULE)
+	psci_run_cpus[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+#endif
+
 
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
@@ -80,7 +97,7 @@ __section("tzfw_coherent_mem")
 
 DEFINE_BAKERY_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
 
-cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
+DEFINE_PER_CPU_ARRAY(cpu_pd_node_t, psci_cpu_pd_nodes);
 
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
@@ -212,11 +229,48 @@ static unsigned int get_power_on_target_pwrlvl(void)
  * does not store the requested state for the CPU power level. Hence an
  * assertion is added to prevent us from accessing the wrong index.
  *****************************************************************************/
+#if PSCI_ATOMIC_COORDINATION
+/******************************************************************************
+ * Helper function to update the local power state requested by the current
+ * cpu for its parent power domain along with the number of cpus requesting the
+ * parent to RUN. The count is published after the requested state so that a
+ * cpu which observes the count going down to zero also observes the requested
+ * states of all the cpus in the domain. Returns the count before the update.
+ *****************************************************************************/
+static unsigned int psci_set_req_parent_pwr_state(unsigned int cpu_idx,
+					plat_local_state_t req_pwr_state)
+{
+	unsigned int *run_cpus;
+	int was_run, is_run;
+
+	run_cpus = &psci_run_cpus[psci_cpu_pd_nodes[cpu_idx].parent_node].count;
+	was_run = is_local_state_run(psci_req_local_pwr_states[0][cpu_idx]);
+	is_run = is_local_state_run(req_pwr_state);
+
+	psci_req_local_pwr_states[0][cpu_idx] = req_pwr_state;
+
+	if (was_run == is_run)
+		return __atomic_load_n(run_cpus, __ATOMIC_SEQ_CST);
+
+	if (is_run)
+		return __atomic_fetch_add(run_cpus, 1, __ATOMIC_SEQ_CST);
+
+	assert(*run_cpus != 0);
+	return __atomic_fetch_sub(run_cpus, 1, __ATOMIC_SEQ_CST);
+}
+#endif
+
 static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
 					 unsigned int cpu_idx,
 					 plat_local_state_t req_pwr_state)
 {
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
+#if PSCI_ATOMIC_COORDINATION
+	if (pwrlvl == PSCI_CPU_PWR_LVL + 1) {
+		psci_set_req_parent_pwr_state(cpu_idx, req_pwr_state);
+		return;
+	}
+#endif
 	psci_req_local_pwr_states[pwrlvl - 1][cpu_idx] = req_pwr_state;
 }
 
@@ -443,6 +497,90 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_ATOMIC_COORDINATION
+/******************************************************************************
+ * This function is the lock-free counterpart of psci_do_state_coordination()
+ * for a cpu entering a low power state. It records the local power states
+ * requested by the current cpu (state_info) for each power level up to
+ * 'end_pwrlvl' without taking any power domain lock.
+ *
+ * If another cpu in the parent power domain of the current cpu has requested
+ * it to RUN, neither the parent nor any of its ancestors can leave the RUN
+ * state so there is nothing to coordinate. The 'state_info' is updated with
+ * RUN for all the non cpu power levels and PSCI_CPU_PWR_LVL is returned.
+ *
+ * Otherwise the current cpu was the last one running in its parent power
+ * domain, 'state_info' is left untouched and 'end_pwrlvl' is returned. The
+ * caller must then acquire the power domain locks and perform the usual state
+ * coordination up to that level.
+ *
+ * This function will only be invoked with data cache enabled and while
+ * powering down a core.
+ *****************************************************************************/
+unsigned int psci_try_local_state_coordination(unsigned int end_pwrlvl,
+					       psci_power_state_t *state_info)
+{
+	unsigned int lvl, cpu_idx = plat_my_core_pos();
+	plat_local_state_t *pd_state = state_info->pwr_domain_state;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL)
+		return PSCI_CPU_PWR_LVL;
+
+	/*
+	 * Update the requested power states top down so that the parent
+	 * power domain count, which other cpus check, changes last.
+	 */
+	for (lvl = end_pwrlvl; lvl > PSCI_CPU_PWR_LVL + 1; lvl--)
+		psci_set_req_local_pwr_state(lvl, cpu_idx, pd_state[lvl]);
+
+	if (psci_set_req_parent_pwr_state(cpu_idx,
+			pd_state[PSCI_CPU_PWR_LVL + 1]) <= 1)
+		return end_pwrlvl;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++)
+		pd_state[lvl] = PSCI_LOCAL_STATE_RUN;
+
+	return PSCI_CPU_PWR_LVL;
+}
+
+/******************************************************************************
+ * This function is the lock-free counterpart of psci_set_pwr_domains_to_run()
+ * for a cpu waking up from a retention state with its caches and coherency
+ * enabled. It sets the requested power state of the current cpu to RUN for all
+ * power levels up to 'end_pwrlvl' without taking any power domain lock.
+ *
+ * If another cpu had already requested the parent power domain to RUN and the
+ * parent is in the RUN state, no power domain above the current cpu has left
+ * the RUN state and PSCI_CPU_PWR_LVL is returned. Otherwise 'end_pwrlvl' is
+ * returned and the caller must acquire the power domain locks and go through
+ * the usual finisher up to that level.
+ *****************************************************************************/
+unsigned int psci_try_local_pwr_domains_to_run(unsigned int end_pwrlvl)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL)
+		return PSCI_CPU_PWR_LVL;
+
+	for (lvl = end_pwrlvl; lvl > PSCI_CPU_PWR_LVL + 1; lvl--)
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     PSCI_LOCAL_STATE_RUN);
+
+	if (psci_set_req_parent_pwr_state(cpu_idx, PSCI_LOCAL_STATE_RUN) == 0)
+		return end_pwrlvl;
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	if (!is_local_state_run(psci_non_cpu_pd_nodes[parent_idx].local_state))
+		return end_pwrlvl;
+
+	return PSCI_CPU_PWR_LVL;
+}
+#endif
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -735,6 +873,10 @@ void psci_warmboot_entrypoint(void)
 {
 	unsigned int end_pwrlvl, cpu_idx = plat_my_core_pos();
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+#if PSCI_STAT_WAKEUP_LATENCY
+	unsigned long long wakeup_ts = read_cntpct_el0();
+	int resuming = 0;
+#endif
 
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
@@ -783,10 +925,14 @@ void psci_warmboot_entrypoint(void)
 	 * of power management handler and perform the generic, architecture
 	 * and platform specific handling.
 	 */
-	if (psci_get_aff_info_state() == AFF_STATE_ON_PENDING)
+	if (psci_get_aff_info_state() == AFF_STATE_ON_PENDING) {
 		psci_cpu_on_finish(cpu_idx, &state_info);
-	else
+	} else {
 		psci_cpu_suspend_finish(cpu_idx, &state_info);
+#if PSCI_STAT_WAKEUP_LATENCY
+		resuming = 1;
+#endif
+	}
 
 	/*
 	 * Set the requested and target state of this CPU and all the higher
@@ -810,6 +956,17 @@ void psci_warmboot_entrypoint(void)
 	 */
 	psci_release_pwr_domain_locks(end_pwrlvl,
 				      cpu_idx);
+
+#if PSCI_STAT_WAKEUP_LATENCY
+	/*
+	 * Account the time taken to get back here from the warm boot entry.
+	 * Only the exit through el3_exit() remains before the normal world
+	 * resumes execution.
+	 */
+	if (resuming)
+		psci_stats_update_wakeup(&state_info,
+					 read_cntpct_el0() - wakeup_ts);
+#endif
 }
 
 /*******************************************************************************
@@ -372,6 +372,38 @@ int psci_features(unsigned int psci_fid)
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * PSCI handler for the CPU_SUSPEND SMCs. It performs the same checks as
+ * psci_smc_handler() and lets the caller dispatch this frequently used call
+ * without going through the switch on the function id.
+ ******************************************************************************/
+u_register_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+			  u_register_t x1,
+			  u_register_t x2,
+			  u_register_t x3,
+			  u_register_t x4,
+			  void *cookie,
+			  void *handle,
+			  u_register_t flags)
+{
+	assert(smc_fid == PSCI_CPU_SUSPEND_AARCH32 ||
+	       smc_fid == PSCI_CPU_SUSPEND_AARCH64);
+
+	if (is_caller_secure(flags))
+		return SMC_UNK;
+
+	if (!(psci_caps & define_psci_cap(smc_fid)))
+		return SMC_UNK;
+
+	if (smc_fid == PSCI_CPU_SUSPEND_AARCH32) {
+		x1 = (uint32_t)x1;
+		x2 = (uint32_t)x2;
+		x3 = (uint32_t)x3;
+	}
+
+	return psci_cpu_suspend(x1, x2, x3);
+}
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
@@ -31,6 +31,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <context_mgmt.h>
 #include <debug.h>
 #include <platform.h>
 #include <pmf.h>
@@ -107,6 +108,11 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	psci_stats_update_pwr_down(end_pwrlvl, &state_info);
 #endif
 
+#if CTX_INCLUDE_FPREGS
+	/* Save the FP/SIMD registers before they lose their contents */
+	cm_fpregs_context_flush();
+#endif
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
 	 * cpu caches.
@@ -38,6 +38,7 @@
 #include <pmf.h>
 #include <psci.h>
 #include <spinlock.h>
+#include <ticket_lock.h>
 
 /*
  * The following helper macros abstract the interface to the Bakery
@@ -97,10 +98,12 @@
 		get_cpu_data_by_index(idx, psci_svc_cpu_data.local_state)
 
 /*
- * Helper macros for the CPU level spinlocks
+ * Helper macros for the CPU level locks
  */
-#define psci_spin_lock_cpu(idx)	spin_lock(&psci_cpu_pd_nodes[idx].cpu_lock)
-#define psci_spin_unlock_cpu(idx) spin_unlock(&psci_cpu_pd_nodes[idx].cpu_lock)
+#define psci_spin_lock_cpu(idx)	\
+		ticket_lock_get(&psci_cpu_pd_nodes[idx].cpu_lock)
+#define psci_spin_unlock_cpu(idx) \
+		ticket_lock_release(&psci_cpu_pd_nodes[idx].cpu_lock)
 
 /* Helper macro to identify a CPU standby request in PSCI Suspend call */
 #define is_cpu_standby_req(is_power_down_state, retn_lvl) \
@@ -162,11 +165,11 @@ typedef struct cpu_pwr_domain_node {
 	/*
 	 * A CPU power domain does not require state coordination like its
 	 * parent power domains. Hence this node does not include a bakery
-	 * lock. A spinlock is required by the CPU_ON handler to prevent a race
-	 * when multiple CPUs try to turn ON the same target CPU.
+	 * lock. A ticket lock is required by the CPU_ON handler to prevent a
+	 * race when multiple CPUs try to turn ON the same target CPU.
 	 */
-	spinlock_t cpu_lock;
-} cpu_pd_node_t;
+	ticket_lock_t cpu_lock;
+} __per_cpu_aligned cpu_pd_node_t;
 
 /*******************************************************************************
  * Data prototypes
@@ -202,6 +205,11 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int node_index[]);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_ATOMIC_COORDINATION
+unsigned int psci_try_local_state_coordination(unsigned int end_pwrlvl,
+					       psci_power_state_t *state_info);
+unsigned int psci_try_local_pwr_domains_to_run(unsigned int end_pwrlvl);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
@@ -252,5 +260,9 @@ u_register_t psci_stat_residency(u_register_t target_cpu,
 			unsigned int power_state);
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
+#if PSCI_STAT_WAKEUP_LATENCY
+void psci_stats_update_wakeup(const psci_power_state_t *state_info,
+			unsigned long long ticks);
+#endif
 
 #endif /* __PSCI_PRIVATE_H__ */
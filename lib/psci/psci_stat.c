@@ -57,11 +57,32 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {-1};
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
+typedef struct psci_cpu_stat {
+	psci_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} __per_cpu_aligned psci_cpu_stat_t;
+
+static DEFINE_PER_CPU_ARRAY(psci_cpu_stat_t, psci_cpu_stat);
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
 
+#if PSCI_STAT_WAKEUP_LATENCY
+/*
+ * Following structure is used to track the time, in ticks, taken by a CPU to
+ * get back to the normal world after being woken up from a power down state.
+ */
+typedef struct psci_wakeup_stat {
+	unsigned long long count;
+	unsigned long long total;
+	unsigned long long max;
+} psci_wakeup_stat_t;
+
+typedef struct psci_cpu_wakeup_stat {
+	psci_wakeup_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} __per_cpu_aligned psci_cpu_wakeup_stat_t;
+
+static DEFINE_PER_CPU_ARRAY(psci_cpu_wakeup_stat_t, psci_cpu_wakeup_stat);
+#endif
+
 /* Register PMF PSCI service */
 PMF_REGISTER_SERVICE(psci_svc, PMF_PSCI_STAT_SVC_ID,
 	 PSCI_STAT_TOTAL_IDS, PMF_STORE_ENABLE)
@@ -69,6 +90,19 @@ PMF_REGISTER_SERVICE(psci_svc, PMF_PSCI_STAT_SVC_ID,
 /* The divisor to use to convert raw timestamp into microseconds */
 u_register_t residency_div;
 
+/*
+ * Initialize the residency divisor if not already initialized
+ */
+static void init_residency_div(void)
+{
+	if (!residency_div) {
+		/* Pre-calculate divisor so that it can be directly used to
+		   convert time-stamp into microseconds */
+		residency_div = read_cntfrq_el0() / MHZ_TICKS_PER_SEC;
+		assert(residency_div);
+	}
+}
+
 /*
  * This macro calculates the stats residency in microseconds,
  * taking in account the wrap around condition.
@@ -162,13 +196,7 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	assert(state_info);
 
-	/* Initialize the residency divisor if not already initialized */
-	if (!residency_div) {
-		/* Pre-calculate divisor so that it can be directly used to
-		   convert time-stamp into microseconds */
-		residency_div = read_cntfrq_el0() / MHZ_TICKS_PER_SEC;
-		assert(residency_div);
-	}
+	init_residency_div();
 
 	/* Get power down time-stamp for current CPU */
 	PMF_GET_TIMESTAMP_BY_INDEX(psci_svc, PSCI_STAT_ID_ENTER_LOW_PWR,
@@ -190,8 +218,8 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	calc_stat_residency(pwrup_ts, pwrdn_ts, residency);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].residency += residency;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].count++;
 
 	/*
 	 * Check what power domains above CPU were off
@@ -230,6 +258,31 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 
 }
 
+#if PSCI_STAT_WAKEUP_LATENCY
+/*******************************************************************************
+ * This function records that the current CPU took `ticks` to get back to the
+ * normal world after waking up from the power down state in `state_info`.
+ * It is called with caches enabled at the end of the warm boot path.
+ ******************************************************************************/
+void psci_stats_update_wakeup(const psci_power_state_t *state_info,
+			unsigned long long ticks)
+{
+	psci_wakeup_stat_t *stat;
+	int stat_idx;
+
+	assert(state_info);
+
+	stat_idx = get_stat_idx(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL],
+				PSCI_CPU_PWR_LVL);
+	stat = &psci_cpu_wakeup_stat[plat_my_core_pos()].stat[stat_idx];
+
+	stat->count++;
+	stat->total += ticks;
+	if (ticks > stat->max)
+		stat->max = ticks;
+}
+#endif
+
 /*******************************************************************************
  * This function returns the appropriate count and residency time of the
  * local state for the highest power level expressed in the `power_state`
@@ -278,7 +331,7 @@ int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat = psci_cpu_stat[target_idx].stat[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
@@ -309,3 +362,65 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+/*******************************************************************************
+ * This function copies the statistics of all the local states of all the
+ * power domains into `buf`, in the layout described by psci_stat_buf_hdr_t.
+ * It allows the normal world to retrieve them through a single SMC instead of
+ * one PSCI_STAT_RESIDENCY and PSCI_STAT_COUNT call per CPU and state. It
+ * returns the number of bytes written or PSCI_E_INVALID_PARAMS if `buf` is too
+ * small.
+ ******************************************************************************/
+int psci_stat_get_all(void *buf, size_t size)
+{
+	psci_stat_buf_hdr_t *hdr = buf;
+	psci_stat_buf_entry_t *entry;
+#if PSCI_STAT_WAKEUP_LATENCY
+	psci_wakeup_stat_t *wakeup_stat;
+#endif
+	size_t total;
+	int i, j;
+
+	total = sizeof(*hdr) + sizeof(*entry) * PLAT_MAX_PWR_LVL_STATES *
+		(PLATFORM_CORE_COUNT + PSCI_NUM_NON_CPU_PWR_DOMAINS);
+	if ((buf == NULL) || (size < total))
+		return PSCI_E_INVALID_PARAMS;
+
+	init_residency_div();
+
+	hdr->version = PSCI_STAT_BUF_VERSION;
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->num_non_cpu_pds = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+	hdr->num_states = PLAT_MAX_PWR_LVL_STATES;
+	entry = (psci_stat_buf_entry_t *)(hdr + 1);
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		for (j = 0; j < PLAT_MAX_PWR_LVL_STATES; j++, entry++) {
+			entry->residency = psci_cpu_stat[i].stat[j].residency;
+			entry->count = psci_cpu_stat[i].stat[j].count;
+#if PSCI_STAT_WAKEUP_LATENCY
+			wakeup_stat = &psci_cpu_wakeup_stat[i].stat[j];
+			entry->wakeup_count = wakeup_stat->count;
+			entry->wakeup_total = wakeup_stat->total /
+						residency_div;
+			entry->wakeup_max = wakeup_stat->max / residency_div;
+#else
+			entry->wakeup_count = 0;
+			entry->wakeup_total = 0;
+			entry->wakeup_max = 0;
+#endif
+		}
+	}
+
+	for (i = 0; i < PSCI_NUM_NON_CPU_PWR_DOMAINS; i++) {
+		for (j = 0; j < PLAT_MAX_PWR_LVL_STATES; j++, entry++) {
+			entry->residency = psci_non_cpu_stat[i][j].residency;
+			entry->count = psci_non_cpu_stat[i][j].count;
+			entry->wakeup_count = 0;
+			entry->wakeup_total = 0;
+			entry->wakeup_max = 0;
+		}
+	}
+
+	return total;
+}
@@ -51,6 +51,15 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 {
 	psci_power_state_t state_info;
 
+#if PSCI_ATOMIC_COORDINATION
+	/*
+	 * Unless this CPU is the first one to wake up in its parent power
+	 * domain, none of the power domains above it can have left the RUN
+	 * state and only the CPU power level needs to be finished.
+	 */
+	end_pwrlvl = psci_try_local_pwr_domains_to_run(end_pwrlvl);
+#endif
+
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				cpu_idx);
 
@@ -109,6 +118,11 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 	 */
 	cm_init_my_context(ep);
 
+#if CTX_INCLUDE_FPREGS
+	/* Save the FP/SIMD registers before they lose their contents */
+	cm_fpregs_context_flush();
+#endif
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
 	 * cpu caches. Currently we assume that the power level correspond
@@ -144,6 +158,7 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 {
 	int skip_wfi = 0;
 	unsigned int idx = plat_my_core_pos();
+	unsigned int coord_pwrlvl = end_pwrlvl;
 
 	/*
 	 * This function must only be called on platforms where the
@@ -152,14 +167,34 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	assert(psci_plat_pm_ops->pwr_domain_suspend &&
 			psci_plat_pm_ops->pwr_domain_suspend_finish);
 
+#if PSCI_ATOMIC_COORDINATION
+	/*
+	 * Check for pending interrupts before the requested states are made
+	 * visible to the other CPUs. Past this point the suspend request is
+	 * not abandoned anymore.
+	 */
+	if (read_isr_el1())
+		return;
+
+	/*
+	 * Record the requested states without taking any lock. The power
+	 * domain locks are only needed if this CPU was the last one running
+	 * in its parent power domain, as otherwise no power domain above the
+	 * CPU power level can change state.
+	 */
+	coord_pwrlvl = psci_try_local_state_coordination(end_pwrlvl,
+							 state_info);
+#endif
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
-	psci_acquire_pwr_domain_locks(end_pwrlvl,
+	psci_acquire_pwr_domain_locks(coord_pwrlvl,
 				      idx);
 
+#if !PSCI_ATOMIC_COORDINATION
 	/*
 	 * We check if there are any pending interrupts after the delay
 	 * introduced by lock contention to increase the chances of early
@@ -169,13 +204,14 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 		skip_wfi = 1;
 		goto exit;
 	}
+#endif
 
 	/*
 	 * This function is passed the requested state info and
 	 * it returns the negotiated state info for each power level upto
 	 * the end level specified.
 	 */
-	psci_do_state_coordination(end_pwrlvl, state_info);
+	psci_do_state_coordination(coord_pwrlvl, state_info);
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -203,12 +239,14 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 		PMF_NO_CACHE_MAINT);
 #endif
 
+#if !PSCI_ATOMIC_COORDINATION
 exit:
+#endif
 	/*
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
-	psci_release_pwr_domain_locks(end_pwrlvl,
+	psci_release_pwr_domain_locks(coord_pwrlvl,
 				  idx);
 	if (skip_wfi)
 		return;
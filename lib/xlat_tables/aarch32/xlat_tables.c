@@ -92,6 +92,22 @@ void init_xlat_tables(void)
 	assert(max_va < ADDR_SPACE_SIZE);
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+void xlat_arch_tlbi_va(uintptr_t va)
+{
+	/* Ensure the translation table write has drained into memory */
+	dsbishst();
+
+	tlbimvaais(va & ~PAGE_SIZE_MASK);
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+	dsbish();
+	isb();
+}
+#endif
+
 /*******************************************************************************
  * Function for enabling the MMU in Secure PL1, assuming that the
  * page-tables have already been created.
@@ -130,6 +130,26 @@ void init_xlat_tables(void)
 	assert(max_va < ADDR_SPACE_SIZE);
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+void xlat_arch_tlbi_va(uintptr_t va)
+{
+	/* Ensure the translation table write has drained into memory */
+	dsbishst();
+
+	/* The operand holds bits [55:12] of the virtual address */
+	if (IS_IN_EL3())
+		tlbivae3is(va >> PAGE_SIZE_SHIFT);
+	else
+		tlbivaae1is(va >> PAGE_SIZE_SHIFT);
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+	dsbish();
+	isb();
+}
+#endif
+
 /*******************************************************************************
  * Macro generating the code for the function enabling the MMU in the given
  * exception level, assuming that the pagetables have already been created.
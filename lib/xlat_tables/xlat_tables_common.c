@@ -33,11 +33,13 @@
 #include <assert.h>
 #include <cassert.h>
 #include <debug.h>
+#include <errno.h>
 #include <platform_def.h>
 #include <string.h>
 #include <types.h>
 #include <utils.h>
 #include <xlat_tables.h>
+#include "xlat_tables_private.h"
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 #define LVL0_SPACER ""
@@ -55,6 +57,16 @@
 
 #define UNSET_DESC	~0ull
 
+/* Shift of the size of the area mapped by an entry at the given level */
+#define XLAT_ADDR_SHIFT(level)	(L0_XLAT_ADDRESS_SHIFT - \
+					(level) * XLAT_TABLE_ENTRIES_SHIFT)
+
+/* Lowest level at which block descriptors can be used */
+#define XLAT_BLOCK_LEVEL_MIN	1
+
+#define DESC_MASK		0x3
+#define TABLE_ADDR_MASK		0x0000fffffffff000ull
+
 static uint64_t xlat_tables[MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
 			__aligned(XLAT_TABLE_SIZE) __section("xlat_table");
 
@@ -62,6 +74,18 @@ static unsigned next_xlat;
 static unsigned long long xlat_max_pa;
 static uintptr_t xlat_max_va;
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/* Attribute flag marking the regions added by mmap_add_dynamic_region() */
+#define MT_DYNAMIC		(1 << 30)
+
+/* Tables released by mmap_remove_dynamic_region(), linked by their entry 0 */
+static uint64_t *xlat_free_tables;
+
+/* Base table and level of the tables built by init_xlation_table() */
+static uint64_t *xlat_base_table;
+static int xlat_base_level;
+#endif
+
 /*
  * Array of all memory regions stored in order of ascending base address.
  * The list is terminated by the first entry with size == 0.
@@ -262,21 +286,75 @@ static uint64_t mmap_desc(unsigned attr, unsigned long long addr_pa,
 	return desc;
 }
 
+/*
+ * State of the sweep through mmap[] done while building the tables. As regions
+ * are sorted by base VA and are either nested or disjoint, the regions that
+ * contain a given VA form a chain. 'mmap_open' holds this chain, outermost
+ * region first, and 'mmap_next' points to the first region that starts after
+ * that VA.
+ */
+static const mmap_region_t *mmap_open[MAX_MMAP_REGIONS];
+static unsigned int mmap_open_depth;
+static const mmap_region_t *mmap_next;
+
+static void mmap_sweep_reset(void)
+{
+	mmap_open_depth = 0;
+	mmap_next = mmap;
+}
+
+/*
+ * Moves the sweep forward to `base_va`. It must not be lower than the address
+ * given in the previous call since the last mmap_sweep_reset().
+ */
+static void mmap_sweep_advance(uintptr_t base_va)
+{
+	const mmap_region_t *mm;
+
+	/* Close the regions that end before base_va, innermost first */
+	while (mmap_open_depth) {
+		mm = mmap_open[mmap_open_depth - 1];
+		if (mm->base_va + mm->size - 1 >= base_va)
+			break;
+		mmap_open_depth--;
+	}
+
+	/*
+	 * Open the regions that contain base_va. Each one is inside all the
+	 * regions that are still open, so the chain remains sorted.
+	 */
+	for (mm = mmap_next; mm->size && mm->base_va <= base_va; ++mm) {
+		if (mm->base_va + mm->size - 1 < base_va)
+			continue; /* Region has already been overtaken */
+
+		assert(mmap_open_depth < ARRAY_SIZE(mmap_open));
+		mmap_open[mmap_open_depth++] = mm;
+	}
+	mmap_next = mm;
+}
+
 /*
  * Returns attributes of area at `base_va` with size `size`. It returns the
  * attributes of the innermost region that contains it. If there are partial
  * overlaps, it returns -1, as a smaller size is needed.
+ *
+ * Only the regions containing `base_va` and the ones starting inside the area
+ * are looked at, so the cost doesn't depend on the total number of regions.
  */
-static int mmap_region_attr(mmap_region_t *mm, uintptr_t base_va,
-					size_t size)
+static int mmap_region_attr(uintptr_t base_va, size_t size)
 {
+	const mmap_region_t *mm;
+	uintptr_t end_va = base_va + size - 1;
+	unsigned int i;
 	/* Don't assume that the area is contained in the first region */
 	int attr = -1;
 
+	mmap_sweep_advance(base_va);
+
 	/*
-	 * Get attributes from last (innermost) region that contains the
-	 * requested area. Don't stop as soon as one region doesn't contain it
-	 * because there may be other internal regions that contain this area:
+	 * Get attributes from the innermost region that contains the requested
+	 * area. Regions which don't override the attributes of the region they
+	 * are in can be ignored:
 	 *
 	 * |-----------------------------1-----------------------------|
 	 * |----2----|     |-------3-------|    |----5----|
@@ -284,30 +362,50 @@ static int mmap_region_attr(mmap_region_t *mm, uintptr_t base_va,
 	 *
 	 *                   |---| <- Area we want the attributes of.
 	 *
-	 * In this example, the area is contained in regions 1, 3 and 4 but not
-	 * in region 2. The loop shouldn't stop at region 2 as inner regions
-	 * have priority over outer regions, it should stop at region 5.
+	 * In this example, the open regions are 1, 3 and 4, and the area gets
+	 * the attributes of region 4.
 	 */
-	for (;; ++mm) {
-
-		if (!mm->size)
-			return attr; /* Reached end of list */
-
-		if (mm->base_va > base_va + size - 1)
-			return attr; /* Next region is after area so end */
-
-		if (mm->base_va + mm->size - 1 < base_va)
-			continue; /* Next region has already been overtaken */
+	for (i = 0; i < mmap_open_depth; i++) {
+		mm = mmap_open[i];
 
 		if (mm->attr == attr)
 			continue; /* Region doesn't override attribs so skip */
 
-		if (mm->base_va > base_va ||
-			mm->base_va + mm->size - 1 < base_va + size - 1)
+		if (mm->base_va + mm->size - 1 < end_va)
 			return -1; /* Region doesn't fully cover our area */
 
 		attr = mm->attr;
 	}
+
+	/* Regions starting inside the area can't cover it */
+	for (mm = mmap_next; mm->size && mm->base_va <= end_va; ++mm) {
+		if (mm->attr != attr)
+			return -1;
+	}
+
+	return attr;
+}
+
+/*
+ * Returns a translation table from the pool, or NULL if there are none left.
+ * Tables given back by mmap_remove_dynamic_region() are reused first.
+ */
+static uint64_t *xlat_table_alloc(void)
+{
+	uint64_t *table;
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	if (xlat_free_tables != NULL) {
+		table = xlat_free_tables;
+		xlat_free_tables = (uint64_t *)(uintptr_t)table[0];
+		return table;
+	}
+#endif
+	if (next_xlat >= MAX_XLAT_TABLES)
+		return NULL;
+
+	table = xlat_tables[next_xlat++];
+	return table;
 }
 
 static mmap_region_t *init_xlation_table_inner(mmap_region_t *mm,
@@ -322,12 +420,18 @@ static mmap_region_t *init_xlation_table_inner(mmap_region_t *mm,
 	u_register_t level_size = (u_register_t)1 << level_size_shift;
 	u_register_t level_index_mask =
 		((u_register_t)XLAT_TABLE_ENTRIES_MASK) << level_size_shift;
+	unsigned long long cont_size =
+		(unsigned long long)level_size << XLAT_CONT_ENTRIES_SHIFT;
+	unsigned int cont_left = 0;
 
 	debug_print("New xlat table:\n");
 
 	do  {
 		uint64_t desc = UNSET_DESC;
 
+		if ((base_va & (cont_size - 1)) == 0)
+			cont_left = 0;
+
 		if (!mm->size) {
 			/* Done mapping regions; finish zeroing the table */
 			desc = INVALID_DESC;
@@ -349,18 +453,37 @@ static mmap_region_t *init_xlation_table_inner(mmap_region_t *mm,
 			 * there are partially overlapping regions. On success,
 			 * it will return the innermost region's attributes.
 			 */
-			int attr = mmap_region_attr(mm, base_va, level_size);
+			int attr = mmap_region_attr(base_va, level_size);
+			unsigned long long pa =
+				base_va - mm->base_va + mm->base_pa;
+
+			/*
+			 * At the start of each group of XLAT_CONT_ENTRIES
+			 * entries, check whether all of them will map the
+			 * same region with the same attributes. If so, they
+			 * are all marked as contiguous so that the TLB can
+			 * hold them as a single entry.
+			 */
+			if (attr >= 0 && level >= XLAT_BLOCK_LEVEL_MIN &&
+			    (base_va & (cont_size - 1)) == 0 &&
+			    (pa & (cont_size - 1)) == 0 &&
+			    base_va + cont_size - 1 <= ADDR_SPACE_SIZE - 1 &&
+			    mmap_region_attr(base_va, cont_size) == attr)
+				cont_left = XLAT_CONT_ENTRIES;
+
 			if (attr >= 0) {
-				desc = mmap_desc(attr,
-					base_va - mm->base_va + mm->base_pa,
-					level);
+				desc = mmap_desc(attr, pa, level);
+				if (cont_left) {
+					desc |= UPPER_ATTRS(CONT_HINT);
+					cont_left--;
+				}
 			}
 		}
 
 		if (desc == UNSET_DESC) {
 			/* Area not covered by a region so need finer table */
-			uint64_t *new_table = xlat_tables[next_xlat++];
-			assert(next_xlat <= MAX_XLAT_TABLES);
+			uint64_t *new_table = xlat_table_alloc();
+			assert(new_table != NULL);
 			desc = TABLE_DESC | (uintptr_t)new_table;
 
 			/* Recurse to fill in new table */
@@ -381,8 +504,244 @@ void init_xlation_table(uintptr_t base_va, uint64_t *table,
 			int level, uintptr_t *max_va,
 			unsigned long long *max_pa)
 {
-
+	mmap_sweep_reset();
 	init_xlation_table_inner(mmap, base_va, table, level);
 	*max_va = xlat_max_va;
 	*max_pa = xlat_max_pa;
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	assert(base_va == 0);
+	xlat_base_table = table;
+	xlat_base_level = level;
+#endif
+}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+static void xlat_table_free(uint64_t *table)
+{
+	table[0] = (uintptr_t)xlat_free_tables;
+	xlat_free_tables = table;
+}
+
+static int xlat_table_is_empty(const uint64_t *table)
+{
+	int i;
+
+	for (i = 0; i < XLAT_TABLE_ENTRIES; i++) {
+		if (table[i] != INVALID_DESC)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Maps the part of region 'mm' which lies within the area from 'table_va' to
+ * 'table_end_va' covered by 'table', a table at 'level'. Each entry uses the
+ * largest block which the alignment of the region allows, and groups of
+ * XLAT_CONT_ENTRIES entries fully inside the region are marked as contiguous.
+ * Returns -ENOMEM if there are no tables left. The entries written so far are
+ * then left in place for the caller to unmap.
+ */
+static int xlat_map_region(const mmap_region_t *mm, uint64_t *table,
+			   int level, uintptr_t table_va,
+			   uintptr_t table_end_va)
+{
+	unsigned int shift = XLAT_ADDR_SHIFT(level);
+	u_register_t level_size = (u_register_t)1 << shift;
+	unsigned long long cont_size =
+		(unsigned long long)level_size << XLAT_CONT_ENTRIES_SHIFT;
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1;
+	uintptr_t start_va, end_va, entry_va;
+	unsigned long long pa, cont_va;
+	unsigned int idx, end_idx;
+	uint64_t desc, *subtable;
+	int rc;
+
+	start_va = (mm->base_va > table_va) ? mm->base_va : table_va;
+	end_va = (mm_end_va < table_end_va) ? mm_end_va : table_end_va;
+	end_idx = (end_va - table_va) >> shift;
+
+	for (idx = (start_va - table_va) >> shift; idx <= end_idx; idx++) {
+		entry_va = table_va + ((uintptr_t)idx << shift);
+		pa = entry_va - mm->base_va + mm->base_pa;
+
+		if (level >= XLAT_BLOCK_LEVEL_MIN && entry_va >= mm->base_va &&
+		    entry_va + level_size - 1 <= mm_end_va &&
+		    (pa & (level_size - 1)) == 0) {
+			/* The whole entry can be mapped with a block */
+			assert(table[idx] == INVALID_DESC);
+			desc = mmap_desc(mm->attr, pa, level);
+
+			cont_va = entry_va & ~(cont_size - 1);
+			if (cont_va >= mm->base_va &&
+			    cont_va + cont_size - 1 <= mm_end_va &&
+			    ((cont_va - mm->base_va + mm->base_pa) &
+			     (cont_size - 1)) == 0)
+				desc |= UPPER_ATTRS(CONT_HINT);
+
+			debug_print("\n");
+			table[idx] = desc;
+			continue;
+		}
+
+		if (table[idx] == INVALID_DESC) {
+			subtable = xlat_table_alloc();
+			if (subtable == NULL)
+				return -ENOMEM;
+			memset(subtable, 0, XLAT_TABLE_SIZE);
+
+			/* Make the table contents visible before linking it */
+			dsbishst();
+			table[idx] = TABLE_DESC | (uintptr_t)subtable;
+		} else {
+			assert((table[idx] & DESC_MASK) == TABLE_DESC);
+			subtable = (uint64_t *)(uintptr_t)
+					(table[idx] & TABLE_ADDR_MASK);
+		}
+
+		rc = xlat_map_region(mm, subtable, level + 1, entry_va,
+				     entry_va + level_size - 1);
+		if (rc != 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+/*
+ * Unmaps the part of region 'mm' which lies within the area covered by
+ * 'table', invalidating the TLB entries of each descriptor removed. Tables
+ * left empty are unlinked and put back in the pool.
+ */
+static void xlat_unmap_region(const mmap_region_t *mm, uint64_t *table,
+			      int level, uintptr_t table_va,
+			      uintptr_t table_end_va)
+{
+	unsigned int shift = XLAT_ADDR_SHIFT(level);
+	u_register_t level_size = (u_register_t)1 << shift;
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1;
+	uintptr_t start_va, end_va, entry_va;
+	unsigned int idx, end_idx;
+	uint64_t *subtable;
+
+	start_va = (mm->base_va > table_va) ? mm->base_va : table_va;
+	end_va = (mm_end_va < table_end_va) ? mm_end_va : table_end_va;
+	end_idx = (end_va - table_va) >> shift;
+
+	for (idx = (start_va - table_va) >> shift; idx <= end_idx; idx++) {
+		entry_va = table_va + ((uintptr_t)idx << shift);
+
+		if (table[idx] == INVALID_DESC)
+			continue;
+
+		if (level == XLAT_TABLE_LEVEL_MAX ||
+		    (table[idx] & DESC_MASK) == BLOCK_DESC) {
+			/* Blocks only ever map a single dynamic region */
+			table[idx] = INVALID_DESC;
+			xlat_arch_tlbi_va(entry_va);
+			continue;
+		}
+
+		subtable = (uint64_t *)(uintptr_t)(table[idx] & TABLE_ADDR_MASK);
+		xlat_unmap_region(mm, subtable, level + 1, entry_va,
+				  entry_va + level_size - 1);
+
+		if (xlat_table_is_empty(subtable)) {
+			/* Also drops the walk cache entries for this table */
+			table[idx] = INVALID_DESC;
+			xlat_arch_tlbi_va(entry_va);
+			xlat_table_free(subtable);
+		}
+	}
+}
+
+int mmap_add_dynamic_region(unsigned long long base_pa, uintptr_t base_va,
+			    size_t size, unsigned int attr)
+{
+	mmap_region_t *mm, region;
+	unsigned long long end_pa = base_pa + size - 1;
+	uintptr_t end_va = base_va + size - 1;
+	int rc;
+
+	if (!size || !IS_PAGE_ALIGNED(base_pa) || !IS_PAGE_ALIGNED(base_va) ||
+	    !IS_PAGE_ALIGNED(size))
+		return -EINVAL;
+
+	if (end_pa < base_pa || end_va < base_va ||
+	    end_va > ADDR_SPACE_SIZE - 1)
+		return -ERANGE;
+
+	/*
+	 * Once the tables are built, the output address size is fixed. It
+	 * always covers at least 4GB and the highest static region.
+	 */
+	if (xlat_base_table != NULL && end_pa > xlat_max_pa &&
+	    end_pa > 0xffffffffull)
+		return -ERANGE;
+
+	for (mm = mmap; mm->size; ++mm) {
+		uintptr_t mm_end_va = mm->base_va + mm->size - 1;
+		unsigned long long mm_end_pa = mm->base_pa + mm->size - 1;
+
+		if (end_va >= mm->base_va && base_va <= mm_end_va)
+			return -EPERM;
+		if (end_pa >= mm->base_pa && base_pa <= mm_end_pa)
+			return -EPERM;
+	}
+
+	if (mmap[MAX_MMAP_REGIONS - 1].size != 0)
+		return -ENOMEM;
+
+	mmap_add_region(base_pa, base_va, size, attr | MT_DYNAMIC);
+
+	if (xlat_base_table == NULL)
+		return 0;
+
+	region.base_pa = base_pa;
+	region.base_va = base_va;
+	region.size = size;
+	region.attr = attr;
+
+	rc = xlat_map_region(&region, xlat_base_table, xlat_base_level,
+			     0, ADDR_SPACE_SIZE - 1);
+	if (rc != 0) {
+		/* Undo the partial mapping and give the tables back */
+		mmap_remove_dynamic_region(base_va, size);
+		return rc;
+	}
+
+	/*
+	 * TLBs do not hold invalid entries so none needs to be invalidated,
+	 * but the new descriptors must be visible before they are used.
+	 */
+	xlat_arch_tlbi_va_sync();
+
+	return 0;
+}
+
+int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
+{
+	mmap_region_t *mm = mmap;
+	mmap_region_t *mm_last = mm + ARRAY_SIZE(mmap) - 1;
+
+	while (mm->size && (mm->base_va != base_va || mm->size != size ||
+			    !(mm->attr & MT_DYNAMIC)))
+		++mm;
+
+	if (!mm->size)
+		return -EINVAL;
+
+	if (xlat_base_table != NULL) {
+		xlat_unmap_region(mm, xlat_base_table, xlat_base_level,
+				  0, ADDR_SPACE_SIZE - 1);
+		xlat_arch_tlbi_va_sync();
+	}
+
+	/* Close the gap, the empty sentinel moves down with the rest */
+	memmove(mm, mm + 1, (uintptr_t)mm_last - (uintptr_t)mm);
+	assert(mm_last->size == 0);
+
+	return 0;
 }
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
@@ -42,4 +42,15 @@ void init_xlation_table(uintptr_t base_va, uint64_t *table,
 			int level, uintptr_t *max_va,
 			unsigned long long *max_pa);
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Invalidate the TLB entries for the given virtual address at the current
+ * exception level in the Inner Shareable domain, after making the previous
+ * translation table writes visible to the table walks.
+ */
+void xlat_arch_tlbi_va(uintptr_t va);
+/* Wait for the invalidations issued by xlat_arch_tlbi_va() to complete */
+void xlat_arch_tlbi_va_sync(void);
+#endif
+
 #endif /* __XLAT_TABLES_PRIVATE_H__ */
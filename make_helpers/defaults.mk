@@ -77,6 +77,9 @@ DEFAULT_PLAT			:= fvp
 # By default, use the -pedantic option in the gcc command line
 DISABLE_PEDANTIC		:= 0
 
+# Flag to let BL31 dispatch interrupts to handlers registered per interrupt ID
+EL3_INTR_ID_DISPATCH		:= 0
+
 # Flag to enable Performance Measurement Framework
 ENABLE_PMF			:= 0
 
@@ -86,9 +89,16 @@ ENABLE_PSCI_STAT		:= 0
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Flag to enable SMC latency histograms using PMF
+ENABLE_SMC_HIST			:= 0
+
 # Build flag to treat usage of deprecated platform and framework APIs as error.
 ERROR_DEPRECATED		:= 0
 
+# Flag to compress the images loaded by BL1 and BL2 with LZ4 when building the
+# FIP, and to build in the decompressor that loads them
+FIP_LZ4				:= 0
+
 # Default FIP file name
 FIP_NAME			:= fip.bin
 
@@ -107,17 +117,31 @@ NS_TIMER_SWITCH			:= 0
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
+# Flag to let the translation table library map and unmap regions at runtime
+PLAT_XLAT_TABLES_DYNAMIC	:= 0
+
 # By default, consider that the platform's reset address is not programmable.
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
 
+# Flag to let CPUs which are not the last running one in their parent power
+# domain suspend without taking the PSCI power domain locks
+PSCI_ATOMIC_COORDINATION	:= 0
+
 # Flag used to choose the power state format viz Extended State-ID or the
 # Original format.
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to track the wake-up latency of the PSCI power down states. Requires
+# ENABLE_PSCI_STAT.
+PSCI_STAT_WAKEUP_LATENCY	:= 0
+
 # By default, BL1 acts as the reset handler, not BL31
 RESET_TO_BL31			:= 0
 
+# Flag to collect statistics on the SMCs dispatched by function id
+RT_SVC_FID_STATS		:= 0
+
 # For Chain of Trust
 SAVE_KEYS			:= 0
 
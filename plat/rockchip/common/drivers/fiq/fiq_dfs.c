@@ -252,7 +252,13 @@ int cpu_dfs_governor_register(void)
 {
 	int ret;
 
+#if EL3_INTR_ID_DISPATCH
+	/* Stop the CPU straight from the FIQ exception vector */
+	ret = register_secfiq_fast_handler(RK_IRQ_SEC_SGI_6,
+					   fiq_cpu_stop_handler);
+#else
 	ret = register_secfiq_handler(RK_IRQ_SEC_SGI_6, fiq_cpu_stop_handler);
+#endif
 	if (ret)
 		return ret;
 
@@ -62,6 +62,74 @@ static inline uint32_t pmu_power_domain_st(uint32_t pd)
 		return pmu_pd_on;
 }
 
+#if PLAT_RK_ASYNC_CPU_ON
+/*
+ * Power domains requested on by pmu_power_domain_req() and not yet seen on,
+ * with the system counter value of each request. They are expected to be
+ * reported on within PD_CTR_LOOP us, as pmu_power_domain_ctr() waits for.
+ */
+static uint32_t pmu_pd_on_pending;
+static uint64_t pmu_pd_on_req_cnt[32];
+
+/*
+ * Request the power domain `pd` to be switched to `pd_state` without waiting
+ * for the PMU to report the new state. A power up is then checked by a later
+ * call to pmu_power_domain_req_check().
+ */
+static inline void pmu_power_domain_req(uint32_t pd, uint32_t pd_state)
+{
+	uint32_t val;
+
+	rockchip_pd_lock_get();
+
+	val = mmio_read_32(PMU_BASE + PMU_PWRDN_CON);
+	if (pd_state == pmu_pd_off) {
+		val |=  BIT(pd);
+		pmu_pd_on_pending &= ~BIT(pd);
+	} else {
+		val &= ~BIT(pd);
+		pmu_pd_on_pending |= BIT(pd);
+		pmu_pd_on_req_cnt[pd] = read_cntpct_el0();
+	}
+
+	mmio_write_32(PMU_BASE + PMU_PWRDN_CON, val);
+	dsb();
+
+	rockchip_pd_lock_rls();
+}
+
+/*
+ * Check the power domains requested on by pmu_power_domain_req(), and warn
+ * about those which the PMU has not reported on in time. Otherwise a core
+ * which never powers up would only be seen as pending forever by PSCI.
+ */
+static inline void pmu_power_domain_req_check(void)
+{
+	uint64_t now;
+	uint32_t pd;
+
+	rockchip_pd_lock_get();
+
+	now = read_cntpct_el0();
+	for (pd = 0; pmu_pd_on_pending >> pd; pd++) {
+		if (!(pmu_pd_on_pending & BIT(pd)))
+			continue;
+
+		if (pmu_power_domain_st(pd) == pmu_pd_on) {
+			pmu_pd_on_pending &= ~BIT(pd);
+		} else if ((now - pmu_pd_on_req_cnt[pd]) >
+			   (uint64_t)PD_CTR_LOOP *
+			   (SYS_COUNTER_FREQ_IN_TICKS / 1000000)) {
+			WARN("%s: %d is not on after %d us!\n",
+			     __func__, pd, PD_CTR_LOOP);
+			pmu_pd_on_pending &= ~BIT(pd);
+		}
+	}
+
+	rockchip_pd_lock_rls();
+}
+#endif
+
 static int pmu_power_domain_ctr(uint32_t pd, uint32_t pd_state)
 {
 	uint32_t val;
@@ -41,6 +41,7 @@
 #define RK_SIP_DDR_CFG32		0x82000008
 #define RK_SIP_SHARE_MEM32		0x82000009
 #define RK_SIP_SIP_VERSION32		0x8200000a
+#define RK_SIP_PSCI_STAT32		0x8200000c
 
 /* RK_SIP_SUSPEND_MODE32 child configs */
 #define SUSPEND_MODE_CONFIG		0x01
@@ -74,7 +75,7 @@
 #define RK_SIP_SVC_VERSION_MINOR	0x1
 
 /* Number of ROCKCHIP SiP Calls implemented */
-#define RK_COMMON_SIP_NUM_CALLS		0x4
+#define RK_COMMON_SIP_NUM_CALLS		0x5
 
 /* SiP Service Calls Error return code */
 #define SIP_RET_SUCCESS			0
@@ -93,6 +94,7 @@ typedef enum {
 	SHARE_PAGE_TYPE_INVALID = 0,
 	SHARE_PAGE_TYPE_UARTDBG,
 	SHARE_PAGE_TYPE_DDR,
+	SHARE_PAGE_TYPE_PSCI_STAT,
 	SHARE_PAGE_TYPE_MAX,
 } share_page_type_t;
 
@@ -111,11 +113,14 @@ struct share_mem_manage {
 
 /* SiP Service Calls */
 int sip_version_handler(struct arm_smccc_res *res);
+int psci_stat_get_handler(struct arm_smccc_res *res);
 int share_mem_type2page_base(share_page_type_t page_type, uint64_t *out_value);
 uint64_t share_mem_type2page_size(share_page_type_t page_type);
 int share_mem_page_get_handler(uint64_t page_num,
 			       share_page_type_t page_type,
 			       struct arm_smccc_res *res);
+int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
+		    uint64_t id, struct arm_smccc_res *res);
 
 uint64_t rockchip_plat_sip_handler(uint32_t smc_fid,
 				   uint64_t x1,
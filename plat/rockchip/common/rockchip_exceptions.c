@@ -37,6 +37,7 @@
 #include <context_mgmt.h>
 #include <cpu_data.h>
 #include <debug.h>
+#include <errno.h>
 #include <gic_common.h>
 #include <interrupt_mgmt.h>
 #include <platform_def.h>
@@ -107,13 +108,33 @@ static uint8_t boot_cpu_msk, boot_cpu;
 #ifndef SPD_opteed
 static cpu_context_t rk_sec_context[PLATFORM_CORE_COUNT];
 #endif
+
+static interrupt_type_handler_t rockchip_get_secfiq_handler(uint32_t id)
+{
+	if (id >= IRQ_NUM_MAX)
+		return NULL;
+
+#if EL3_INTR_ID_DISPATCH
+	/*
+	 * The interrupts registered with BL31 are dispatched before reaching
+	 * here, unless they got pending while other interrupts were handled.
+	 */
+	if (!rockchip_secfiq_handler[id])
+		return get_interrupt_handler(id);
+#endif
+
+	return rockchip_secfiq_handler[id];
+}
+
 static uint64_t gic_handle_irq(uint32_t id,
 			       uint32_t flags,
 			       void *handle,
 			       void *cookie)
 {
-	if (rockchip_secfiq_handler[id])
-		return rockchip_secfiq_handler[id] (id, flags, handle, cookie);
+	interrupt_type_handler_t handler = rockchip_get_secfiq_handler(id);
+
+	if (handler)
+		return handler(id, flags, handle, cookie);
 	else
 		return GIC_RET_ERRORID;
 }
@@ -136,10 +157,12 @@ static uint64_t gic_handle_ipi(uint32_t id,
 			       void *handle,
 			       void *cookie)
 {
+	interrupt_type_handler_t handler = rockchip_get_secfiq_handler(id);
+
 	assert(handle == cm_get_context(NON_SECURE));
 
-	if (rockchip_secfiq_handler[id])
-		return rockchip_secfiq_handler[id] (id, flags, handle, cookie);
+	if (handler)
+		return handler(id, flags, handle, cookie);
 	else
 		return GIC_RET_ERRORID;
 }
@@ -157,7 +180,16 @@ static uint64_t gic_handle_except(uint32_t id,
 	 * pointer
 	 */
 	do {
-		irqstat = plat_ic_acknowledge_interrupt();
+		/*
+		 * An interrupt already acknowledged by BL31 comes with its
+		 * raw value as 'id', see dispatch_acked_interrupt().
+		 */
+		if (id != INTR_ID_UNAVAILABLE) {
+			irqstat = id;
+			id = INTR_ID_UNAVAILABLE;
+		} else {
+			irqstat = plat_ic_acknowledge_interrupt();
+		}
 		irqnr = irqstat & GICC_IAR_INT_ID_MASK;
 
 		if (irqnr > 15 && irqnr < 1021) {
@@ -293,6 +325,32 @@ int32_t register_secfiq_handler(uint32_t id, interrupt_type_handler_t handler)
 	return SIP_RET_SUCCESS;
 }
 
+#if EL3_INTR_ID_DISPATCH
+/*
+ * Register a handler which BL31 calls right from the exception vector, with
+ * only the caller saved registers of the interrupted context saved. It must
+ * not switch context nor unmask the interrupts.
+ */
+int32_t register_secfiq_fast_handler(uint32_t id,
+				     interrupt_type_handler_t handler)
+{
+	int32_t rc;
+
+#ifndef PLAT_SKIP_OPTEE_S_EL1_INT_REGISTER
+	return SIP_RET_NOT_SUPPORTED;
+#endif
+
+	if (!rockchip_secure_interrupt_setup)
+		return SIP_RET_NOT_SUPPORTED;
+
+	rc = register_interrupt_handler(id, handler, INTR_ID_FLAG_FAST);
+	if (rc == -EALREADY && get_interrupt_handler(id) == handler)
+		rc = 0;
+
+	return rc ? SIP_RET_INVALID_PARAMS : SIP_RET_SUCCESS;
+}
+#endif
+
 /***************************uart_dbg****************************/
 static void uartdbg_to_oshdl_handler(uint64_t handler, void *handle_ctx)
 {
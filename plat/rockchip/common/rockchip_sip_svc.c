@@ -29,6 +29,8 @@
 #include <fiq_dfs.h>
 #include <mmio.h>
 #include <plat_sip_calls.h>
+#include <pmf.h>
+#include <psci.h>
 #include <rockchip_sip_svc.h>
 #include <runtime_svc.h>
 #include <string.h>
@@ -50,6 +52,34 @@ int sip_version_handler(struct arm_smccc_res *res)
 	return SIP_RET_SUCCESS;
 }
 
+/*
+ * Copy the PSCI statistics of all the cpus and power domains into the
+ * SHARE_PAGE_TYPE_PSCI_STAT share memory page(s), which must have been
+ * requested through RK_SIP_SHARE_MEM32 beforehand.
+ * res->a1: number of bytes written
+ */
+int psci_stat_get_handler(struct arm_smccc_res *res)
+{
+#if ENABLE_PSCI_STAT
+	uint64_t page_base;
+	int ret;
+
+	ret = share_mem_type2page_base(SHARE_PAGE_TYPE_PSCI_STAT, &page_base);
+	if (ret)
+		return ret;
+
+	ret = psci_stat_get_all((void *)page_base,
+			share_mem_type2page_size(SHARE_PAGE_TYPE_PSCI_STAT));
+	if (ret < 0)
+		return SIP_RET_INVALID_PARAMS;
+
+	res->a1 = ret;
+	return SIP_RET_SUCCESS;
+#else
+	return SIP_RET_NOT_SUPPORTED;
+#endif
+}
+
 /****************************** share mem smc *********************************/
 #pragma weak fiq_debugger_smc_handler
 uint64_t fiq_debugger_smc_handler(uint64_t fun_id, void *handle,
@@ -268,7 +298,7 @@ int ddr_plat_smc_handler(uint64_t arg0, uint64_t arg1,
  * return: 0 smc call SUCCESS, other smc call FAIL
  * res->a1, function return value
  */
-static int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
+int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
 			   uint64_t id, struct arm_smccc_res *res)
 {
 	switch (id) {
@@ -309,6 +339,53 @@ static int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
 }
 #endif
 
+/*
+ * DDR frequency scaling calls are issued at a high rate by the DMC devfreq
+ * driver, so they are dispatched directly through the per function id table.
+ */
+static uint64_t sip_ddr_cfg_smc_handler(uint32_t smc_fid,
+					uint64_t x1,
+					uint64_t x2,
+					uint64_t x3,
+					uint64_t x4,
+					void *cookie,
+					void *handle,
+					uint64_t flags)
+{
+	int ret;
+	struct arm_smccc_res res = {0};
+
+	if (!is_caller_non_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	ret = ddr_smc_handler(x1, x2, x3, &res);
+	SMC_RET4(handle, ret, res.a1, res.a2, res.a3);
+}
+
+DECLARE_RT_SVC_FID(
+	rockchip_sip_ddr_cfg,
+	RK_SIP_DDR_CFG32,
+	sip_ddr_cfg_smc_handler
+);
+
+#if ENABLE_SMC_HIST
+/*
+ * The Rockchip SiP function ids overlap the range matched by is_pmf_fid(), so
+ * only the PMF function ids themselves are routed to the PMF SMC handler.
+ */
+#define RK_PMF_SIP_NUM_CALLS		PMF_NUM_SMC_CALLS
+
+static int sip_svc_setup(void)
+{
+	if (pmf_setup() != 0)
+		return 1;
+	return 0;
+}
+#else
+#define RK_PMF_SIP_NUM_CALLS		0
+#define sip_svc_setup			NULL
+#endif
+
 /*
  * This function is responsible for handling all SiP calls from the NS world
  */
@@ -333,8 +410,8 @@ uint64_t sip_smc_handler(uint32_t smc_fid,
 	switch (smc_fid) {
 	case SIP_SVC_CALL_COUNT:
 		/* Return the number of Rockchip SiP Service Calls. */
-		SMC_RET1(handle,
-			 RK_COMMON_SIP_NUM_CALLS + RK_PLAT_SIP_NUM_CALLS);
+		SMC_RET1(handle, RK_COMMON_SIP_NUM_CALLS +
+			 RK_PLAT_SIP_NUM_CALLS + RK_PMF_SIP_NUM_CALLS);
 
 	case SIP_SVC_UID:
 		/* Return UID to the caller */
@@ -361,11 +438,22 @@ uint64_t sip_smc_handler(uint32_t smc_fid,
 		ret = regs_access(x1, x2, x3, &res);
 		SMC_RET2(handle, ret, res.a1);
 
-#ifndef PLAT_rk3399
+	case RK_SIP_PSCI_STAT32:
+		ret = psci_stat_get_handler(&res);
+		SMC_RET2(handle, ret, res.a1);
+
 	case RK_SIP_DDR_CFG32:
 		memset(&res, 0, sizeof(res));
 		ret = ddr_smc_handler(x1, x2, x3, &res);
 		SMC_RET4(handle, ret, res.a1, res.a2, res.a3);
+
+#if ENABLE_SMC_HIST
+	case PMF_SMC_GET_TIMESTAMP_32:
+	case PMF_SMC_GET_TIMESTAMP_64:
+	case PMF_SMC_GET_SMC_HIST_32:
+	case PMF_SMC_GET_SMC_HIST_64:
+		return pmf_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				       handle, flags);
 #endif
 
 	default:
@@ -380,6 +468,6 @@ DECLARE_RT_SVC(
 	OEN_SIP_START,
 	OEN_SIP_END,
 	SMC_TYPE_FAST,
-	NULL,
+	sip_svc_setup,
 	sip_smc_handler
 );
@@ -138,6 +138,9 @@
  */
 #define PLAT_RK_G1S_IRQS	RK_G1S_IRQS
 
+/* The GICv2 reports the Group 0 interrupts as INTR_TYPE_S_EL1 */
+#define PLAT_EL3_INTR_ID_TYPE	INTR_TYPE_S_EL1
+
 #define PLAT_RK_UART_BASE	RK3366_UART2_BASE
 #define PLAT_RK_UART_CLOCK	RK3366_UART_CLOCK
 #define PLAT_RK_UART_BAUDRATE	RK3366_BAUDRATE
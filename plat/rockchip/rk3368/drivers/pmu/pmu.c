@@ -503,6 +503,31 @@ void rk3368_cpu_pwr_dm_off(uint32_t target_idx)
 	cpus_id_power_domain(cluster, cpu, pmu_pd_off, CKECK_WFEI_MSK);
 }
 
+#if PLAT_RK_ASYNC_CPU_ON
+/*
+ * Switch the boot address of the cluster back to the cold boot address, unless
+ * a core of the cluster has been powered up and has not yet entered
+ * platform_cpu_warmboot. Must be called with the rockchip_pd_lock held.
+ */
+static void cpus_cluster_boot_addr_restore(uint32_t cluster)
+{
+	uint32_t cpu, first_cpu, cpu_count;
+
+	first_cpu = cluster * PLATFORM_CLUSTER0_CORE_COUNT;
+	cpu_count = cluster ? PLATFORM_CLUSTER1_CORE_COUNT :
+			      PLATFORM_CLUSTER0_CORE_COUNT;
+
+	for (cpu = first_cpu; cpu < first_cpu + cpu_count; cpu++) {
+		if (cpuson_flags[cpu] == PMU_CPU_HOTPLUG)
+			return;
+	}
+
+	mmio_write_32(SGRF_BASE + SGRF_SOC_CON(1 + cluster),
+		      (COLD_BOOT_BASE >> CPU_BOOT_ADDR_ALIGN) |
+		      CPU_BOOT_ADDR_WMASK);
+}
+#endif
+
 int rockchip_soc_cores_pwr_dm_on(unsigned long mpidr,
 				 uint64_t entrypoint)
 {
@@ -518,6 +543,17 @@ int rockchip_soc_cores_pwr_dm_on(unsigned long mpidr,
 	cpuon_id = (cluster * PLATFORM_CLUSTER0_CORE_COUNT) + cpu;
 	assert(cpuon_id < PLATFORM_CORE_COUNT);
 	assert(cpuson_flags[cpuon_id] == 0);
+
+#if PLAT_RK_ASYNC_CPU_ON
+	pmu_power_domain_req_check();
+
+	/*
+	 * Serialise with the cores of the cluster which are booting, so that
+	 * they do not switch the boot address back before this core boots.
+	 */
+	rockchip_pd_lock_get();
+#endif
+
 	cpuson_flags[cpuon_id] = PMU_CPU_HOTPLUG;
 	cpuson_entry_point[cpuon_id] = entrypoint;
 
@@ -527,17 +563,38 @@ int rockchip_soc_cores_pwr_dm_on(unsigned long mpidr,
 		      CPU_BOOT_ADDR_WMASK);
 	dsb();
 
+#if PLAT_RK_ASYNC_CPU_ON
+	rockchip_pd_lock_rls();
+
+	/*
+	 * Do not wait for the core to be reported on. The boot address is
+	 * switched back by the last core of the cluster to boot, in
+	 * rockchip_soc_cores_pwr_dm_on_finish(). The power up is checked by
+	 * the next CPU_ON or core power up.
+	 */
+	pmu_power_domain_req(cluster ? PD_CPUB0 + cpu : PD_CPUL0 + cpu,
+			     pmu_pd_on);
+#else
 	cpus_id_power_domain(cluster, cpu, pmu_pd_on, CKECK_WFEI_MSK);
 
 	mmio_write_32(SGRF_BASE + SGRF_SOC_CON(1 + cluster),
 		      (COLD_BOOT_BASE >> CPU_BOOT_ADDR_ALIGN) |
 		      CPU_BOOT_ADDR_WMASK);
+#endif
 
 	return 0;
 }
 
 int rockchip_soc_cores_pwr_dm_on_finish(void)
 {
+#if PLAT_RK_ASYNC_CPU_ON
+	rockchip_pd_lock_get();
+	cpus_cluster_boot_addr_restore(MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
+	rockchip_pd_lock_rls();
+
+	pmu_power_domain_req_check();
+#endif
+
 	return 0;
 }
 
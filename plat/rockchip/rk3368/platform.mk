@@ -86,3 +86,8 @@ ENABLE_PLAT_COMPAT	:=      0
 $(eval $(call add_define,PLAT_EXTRA_LD_SCRIPT))
 $(eval $(call add_define,PLAT_SKIP_OPTEE_S_EL1_INT_REGISTER))
 $(eval $(call add_define,PLAT_SKIP_DFS_TLB_DCACHE_MAINTENANCE))
+
+# Do not wait for the PMU to report a core powered up in CPU_ON. Disabled
+# until it has been boot-tested on hardware.
+PLAT_RK_ASYNC_CPU_ON	:=	0
+$(eval $(call add_define,PLAT_RK_ASYNC_CPU_ON))
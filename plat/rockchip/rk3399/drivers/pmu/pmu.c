@@ -493,7 +493,17 @@ static int cpus_power_domain_on(uint32_t cpu_id)
 			pmu_power_domain_ctr(cpu_pd, pmu_pd_off);
 		}
 
+#if PLAT_RK_ASYNC_CPU_ON
+		/*
+		 * Do not wait for the core to be reported on. Its arrival in
+		 * platform_cpu_warmboot is what PSCI waits for anyway, and the
+		 * callers can power up the other cores meanwhile. The power up
+		 * is checked by the next CPU_ON or core power up.
+		 */
+		pmu_power_domain_req(cpu_pd, pmu_pd_on);
+#else
 		pmu_power_domain_ctr(cpu_pd, pmu_pd_on);
+#endif
 	} else {
 		if (pmu_power_domain_st(cpu_pd) == pmu_pd_on) {
 			WARN("%s: cpu%d is not in off,!\n", __func__, cpu_id);
@@ -631,6 +641,11 @@ int rockchip_soc_cores_pwr_dm_on(unsigned long mpidr, uint64_t entrypoint)
 
 	assert(cpu_id < PLATFORM_CORE_COUNT);
 	assert(cpuson_flags[cpu_id] == 0);
+
+#if PLAT_RK_ASYNC_CPU_ON
+	pmu_power_domain_req_check();
+#endif
+
 	cpuson_flags[cpu_id] = PMU_CPU_HOTPLUG;
 	cpuson_entry_point[cpu_id] = entrypoint;
 	dsb();
@@ -697,6 +712,11 @@ int rockchip_soc_cores_pwr_dm_on_finish(void)
 
 	mmio_write_32(PMU_BASE + PMU_CORE_PM_CON(cpu_id),
 		      CORES_PM_DISABLE);
+
+#if PLAT_RK_ASYNC_CPU_ON
+	pmu_power_domain_req_check();
+#endif
+
 	return PSCI_E_SUCCESS;
 }
 
@@ -43,7 +43,7 @@ int suspend_mode_handler(uint64_t mode_id, uint64_t config1, uint64_t config2)
 	return 0;
 }
 
-static int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
+int ddr_smc_handler(uint64_t arg0, uint64_t arg1,
 		    uint64_t id, struct arm_smccc_res *res)
 {
 	switch (id) {
@@ -80,10 +80,6 @@ uint64_t rockchip_plat_sip_handler(uint32_t smc_fid,
 
 	switch (smc_fid) {
 
-	case RK_SIP_DDR_CFG32:
-		ret = ddr_smc_handler(x1, x2, x3, &res);
-		SMC_RET4(handle, ret, res.a1, res.a2, res.a3);
-
 	case RK_SIP_SUSPEND_MODE32:
 		SMC_RET1(handle, suspend_mode_handler(x1, x2, x3));
 
@@ -94,6 +94,11 @@ ENABLE_PLAT_COMPAT      :=      0
 
 $(eval $(call add_define,PLAT_EXTRA_LD_SCRIPT))
 
+# Do not wait for the PMU to report a core powered up in CPU_ON. Disabled
+# until it has been boot-tested on hardware.
+PLAT_RK_ASYNC_CPU_ON	:=	0
+$(eval $(call add_define,PLAT_RK_ASYNC_CPU_ON))
+
 # M0 source build
 PLAT_M0                 :=      ${PLAT}m0
 BUILD_M0		:=	${BUILD_PLAT}/m0
@@ -154,6 +154,16 @@ int32_t opteed_setup(void)
 				optee_ep_info->pc,
 				&opteed_sp_context[linear_id]);
 
+	/*
+	 * OPTEE runs Trusted Applications at S-EL0 and takes exceptions from
+	 * them, so it modifies the EL0 thread ID and the fault registers. The
+	 * AArch32 EL1 registers are only used when OPTEE itself executes in
+	 * AArch32 state.
+	 */
+	cm_set_el1_sysregs_switch_groups(CTX_EL1_REGS_EL0_TID |
+		CTX_EL1_REGS_FAULT |
+		((opteed_rw == OPTEE_AARCH32) ? CTX_EL1_REGS_AARCH32 : 0));
+
 	/*
 	 * All OPTEED initialization done. Now register our init function with
 	 * BL31 for deferred invocation
@@ -199,6 +209,33 @@ static int32_t opteed_init(void)
 }
 
 
+/*******************************************************************************
+ * OPTEE is returning from a call or being preempted from a call. The results
+ * are in x1-x4. Copy them into the non-secure context, save the secure state
+ * and return to the non-secure state.
+ ******************************************************************************/
+static uint64_t opteed_return_call_done(uint64_t x1,
+					uint64_t x2,
+					uint64_t x3,
+					uint64_t x4,
+					void *handle)
+{
+	cpu_context_t *ns_cpu_context;
+
+	assert(handle == cm_get_context(SECURE));
+	cm_el1_sysregs_context_save(SECURE);
+
+	/* Get a reference to the non-secure context */
+	ns_cpu_context = cm_get_context(NON_SECURE);
+	assert(ns_cpu_context);
+
+	/* Restore non-secure state */
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
+}
+
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -376,24 +413,7 @@ skip:
 	 * either case execution should resume in the normal world.
 	 */
 	case TEESMC_OPTEED_RETURN_CALL_DONE:
-		/*
-		 * This is the result from the secure client of an
-		 * earlier request. The results are in x0-x3. Copy it
-		 * into the non-secure context, save the secure state
-		 * and return to the non-secure state.
-		 */
-		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
-
-		/* Get a reference to the non-secure context */
-		ns_cpu_context = cm_get_context(NON_SECURE);
-		assert(ns_cpu_context);
-
-		/* Restore non-secure state */
-		cm_el1_sysregs_context_restore(NON_SECURE);
-		cm_set_next_eret_context(NON_SECURE);
-
-		SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
+		return opteed_return_call_done(x1, x2, x3, x4, handle);
 
 	/*
 	 * OPTEE has finished handling a S-EL1 FIQ interrupt. Execution
@@ -440,3 +460,30 @@ DECLARE_RT_SVC(
 	NULL,
 	opteed_smc_handler
 );
+
+/*******************************************************************************
+ * Every yielding call to OPTEE completes with TEESMC_OPTEED_RETURN_CALL_DONE.
+ * Dispatch it directly through the per function id table. The same function
+ * id issued from the non-secure state is forwarded to OPTEE as usual.
+ ******************************************************************************/
+static uint64_t opteed_call_done_smc_handler(uint32_t smc_fid,
+			 uint64_t x1,
+			 uint64_t x2,
+			 uint64_t x3,
+			 uint64_t x4,
+			 void *cookie,
+			 void *handle,
+			 uint64_t flags)
+{
+	if (is_caller_non_secure(flags))
+		return opteed_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					  handle, flags);
+
+	return opteed_return_call_done(x1, x2, x3, x4, handle);
+}
+
+DECLARE_RT_SVC_FID(
+	opteed_call_done,
+	TEESMC_OPTEED_RETURN_CALL_DONE,
+	opteed_call_done_smc_handler
+);
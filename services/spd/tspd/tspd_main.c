@@ -240,6 +240,14 @@ int32_t tspd_setup(void)
 				tsp_ep_info->pc,
 				&tspd_sp_context[linear_id]);
 
+	/*
+	 * The TSP runs in AArch64 state without any S-EL0 code, does not
+	 * use address translation instructions and does not expect to take
+	 * synchronous exceptions. None of the optional EL1 system register
+	 * groups need to be switched on its behalf.
+	 */
+	cm_set_el1_sysregs_switch_groups(CTX_EL1_REGS_MIN);
+
 #if TSP_INIT_ASYNC
 	bl31_set_next_image_type(SECURE);
 #else
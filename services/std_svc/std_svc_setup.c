@@ -40,6 +40,16 @@
 #include <stdint.h>
 #include <uuid.h>
 
+/* Prototype of the PSCI library SMC handlers */
+typedef u_register_t (*psci_smc_handler_t)(uint32_t smc_fid,
+					   u_register_t x1,
+					   u_register_t x2,
+					   u_register_t x3,
+					   u_register_t x4,
+					   void *cookie,
+					   void *handle,
+					   u_register_t flags);
+
 /* Standard Service UUID */
 DEFINE_SVC_UUID(arm_svc_uid,
 		0x108d905b, 0xf863, 0x47e8, 0xae, 0x2d,
@@ -60,6 +70,45 @@ static int32_t std_svc_setup(void)
 	return psci_setup((const psci_lib_args_t *)svc_arg);
 }
 
+/*
+ * Call a PSCI SMC handler, collecting the runtime instrumentation timestamps
+ * around it if enabled
+ */
+static uint64_t std_svc_psci_call(psci_smc_handler_t psci_handler,
+				  uint32_t smc_fid,
+				  u_register_t x1,
+				  u_register_t x2,
+				  u_register_t x3,
+				  u_register_t x4,
+				  void *cookie,
+				  void *handle,
+				  u_register_t flags)
+{
+	uint64_t ret;
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+
+	/*
+	 * Flush cache line so that even if CPU power down happens
+	 * the timestamp update is reflected in memory.
+	 */
+	PMF_WRITE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_ENTER_PSCI,
+	    PMF_CACHE_MAINT,
+	    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+#endif
+
+	ret = psci_handler(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_PSCI,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	return ret;
+}
+
 /*
  * Top-level Standard Service SMC handler. This handler will in turn dispatch
  * calls to PSCI SMC handler
@@ -78,30 +127,8 @@ uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 	 * value
 	 */
 	if (is_psci_fid(smc_fid)) {
-		uint64_t ret;
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-
-		/*
-		 * Flush cache line so that even if CPU power down happens
-		 * the timestamp update is reflected in memory.
-		 */
-		PMF_WRITE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_ENTER_PSCI,
-		    PMF_CACHE_MAINT,
-		    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
-#endif
-
-		ret = psci_smc_handler(smc_fid, x1, x2, x3, x4,
-		    cookie, handle, flags);
-
-#if ENABLE_RUNTIME_INSTRUMENTATION
-		PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
-		    RT_INSTR_EXIT_PSCI,
-		    PMF_NO_CACHE_MAINT);
-#endif
-
-		SMC_RET1(handle, ret);
+		SMC_RET1(handle, std_svc_psci_call(psci_smc_handler, smc_fid,
+			x1, x2, x3, x4, cookie, handle, flags));
 	}
 
 	switch (smc_fid) {
@@ -126,6 +153,23 @@ uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+/*
+ * Handler for PSCI CPU_SUSPEND, the most frequently used PSCI call, installed
+ * in the per function id dispatch table
+ */
+static uintptr_t std_svc_cpu_suspend_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	SMC_RET1(handle, std_svc_psci_call(psci_cpu_suspend_smc_handler,
+		smc_fid, x1, x2, x3, x4, cookie, handle, flags));
+}
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		std_svc,
@@ -136,3 +180,15 @@ DECLARE_RT_SVC(
 		std_svc_setup,
 		std_svc_smc_handler
 );
+
+DECLARE_RT_SVC_FID(
+		psci_cpu_suspend32,
+		PSCI_CPU_SUSPEND_AARCH32,
+		std_svc_cpu_suspend_handler
+);
+
+DECLARE_RT_SVC_FID(
+		psci_cpu_suspend64,
+		PSCI_CPU_SUSPEND_AARCH64,
+		std_svc_cpu_suspend_handler
+);
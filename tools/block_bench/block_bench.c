@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host benchmark for the block device driver. It reads from a RAM backed
+ * block device with the driver code used by the firmware, from block aligned
+ * and unaligned file positions into block aligned and unaligned destinations,
+ * checks the data read and reports the number of requests issued to the
+ * device, the number of bytes staged through the block buffer and the
+ * throughput. Each request can be given a fixed cost to model the command
+ * overhead of a real device. The asynchronous reads used by load_image() can
+ * be measured instead of the synchronous ones.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the driver into this program to get at its internal functions */
+#include "../../drivers/io/io_block.c"
+
+#define DEFAULT_ITERATIONS	100
+#define DEFAULT_BLOCK_SIZE	0x200
+#define DEFAULT_BUF_SIZE	0x1000
+#define DEFAULT_READ_SIZE	0x100000
+
+static size_t block_size = DEFAULT_BLOCK_SIZE;
+static size_t buf_size = DEFAULT_BUF_SIZE;
+static size_t read_size = DEFAULT_READ_SIZE;
+static size_t max_read_size;
+static unsigned long request_ns;
+static int async;
+
+static uint8_t *disk;
+static size_t disk_size;
+static uint8_t *block_buf;
+
+static unsigned long requests;
+static unsigned long long staged_bytes;
+
+/* Read positions and destination offsets measured */
+static const struct {
+	const char *name;
+	size_t file_off;
+	size_t dst_off;
+} cases[] = {
+	{ "aligned",			0,	0 },
+	{ "unaligned file position",	0x10,	0 },
+	{ "unaligned destination",	0,	0x10 },
+	{ "both unaligned",		0x10,	0x10 },
+};
+
+/* Provided by the IO framework in the firmware */
+int io_register_device(const io_dev_info_t *dev_info)
+{
+	return 0;
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Read queued by ram_read_start() */
+static int async_lba;
+static uintptr_t async_buf;
+static size_t async_size;
+
+static size_t ram_read(int lba, uintptr_t buf, size_t size)
+{
+	struct timespec start, ts;
+
+	if ((size_t)lba * block_size + size > disk_size ||
+	    size > (max_read_size != 0 ? max_read_size : buf_size))
+		return 0;
+
+	memcpy((void *)buf, disk + (size_t)lba * block_size, size);
+	requests++;
+	if (buf >= (uintptr_t)block_buf && buf < (uintptr_t)block_buf + buf_size)
+		staged_bytes += size;
+
+	/* Model the fixed cost of a request on the device */
+	if (request_ns != 0) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		do {
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+		} while ((ts.tv_sec - start.tv_sec) * 1000000000ul +
+			 ts.tv_nsec - start.tv_nsec < request_ns);
+	}
+
+	return size;
+}
+
+/* The data is only copied when waited for, as a DMA would land it late */
+static int ram_read_start(int lba, uintptr_t buf, size_t size)
+{
+	if (async_size != 0 || (buf & (block_size - 1)) != 0 ||
+	    (size & (block_size - 1)) != 0)
+		return -EINVAL;
+
+	async_lba = lba;
+	async_buf = buf;
+	async_size = size;
+	return 0;
+}
+
+static size_t ram_read_wait(void)
+{
+	size_t size;
+
+	size = ram_read(async_lba, async_buf, async_size);
+	async_size = 0;
+	return size;
+}
+
+static size_t ram_write(int lba, const uintptr_t buf, size_t size)
+{
+	return 0;
+}
+
+static void usage(void)
+{
+	printf("block_bench [-a] [-i <iterations>] [-B <block size>] "
+	    "[-b <buffer size>] [-m <max read size>] [-s <read size>] "
+	    "[-r <request ns>]\n");
+	printf("  -a\t\t\tUse asynchronous reads.\n");
+	printf("  -i <iterations>\tNumber of times each read is done "
+	    "(default %d).\n", DEFAULT_ITERATIONS);
+	printf("  -B <block size>\tBlock size of the device "
+	    "(default 0x%x).\n", DEFAULT_BLOCK_SIZE);
+	printf("  -b <buffer size>\tSize of the block buffer "
+	    "(default 0x%x).\n", DEFAULT_BUF_SIZE);
+	printf("  -m <max read size>\tLargest request accepted by the device "
+	    "(default: the buffer size).\n");
+	printf("  -s <read size>\tSize of each read (default 0x%x).\n",
+	    DEFAULT_READ_SIZE);
+	printf("  -r <request ns>\tFixed cost of a device request "
+	    "(default 0).\n");
+	exit(1);
+}
+
+static int bench_case(io_dev_info_t *dev_info, unsigned int i_case,
+		      unsigned int iterations)
+{
+	io_block_spec_t region = { 0, disk_size };
+	io_entity_t entity = { 0 };
+	size_t file_off = cases[i_case].file_off;
+	size_t length_read;
+	double start, elapsed;
+	uint8_t *dst_buf, *dst;
+	unsigned int i;
+	int rc, ret = 0;
+
+	dst_buf = aligned_alloc(block_size, read_size + block_size);
+	if (dst_buf == NULL) {
+		fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+		exit(1);
+	}
+	dst = dst_buf + cases[i_case].dst_off;
+
+	requests = 0;
+	staged_bytes = 0;
+	start = now_us();
+	for (i = 0; i < iterations; i++) {
+		block_open(dev_info, (uintptr_t)&region, &entity);
+		block_seek(&entity, IO_SEEK_SET, file_off);
+		if (async)
+			rc = block_read_start(&entity, (uintptr_t)dst,
+			    read_size);
+		else
+			rc = -ENODEV;
+		if (rc == 0)
+			rc = block_read_wait(&entity, &length_read);
+		else if (rc == -ENODEV)
+			rc = block_read(&entity, (uintptr_t)dst, read_size,
+			    &length_read);
+		if (rc != 0 || length_read != read_size) {
+			fprintf(stderr, "ERROR: %s: read failed\n",
+			    cases[i_case].name);
+			ret = 1;
+			break;
+		}
+		block_close(&entity);
+	}
+	elapsed = now_us() - start;
+
+	if (ret == 0 && memcmp(dst, disk + file_off, read_size) != 0) {
+		fprintf(stderr, "ERROR: %s: data mismatch\n",
+		    cases[i_case].name);
+		ret = 1;
+	}
+
+	if (ret == 0) {
+		/* Bytes per us are MB/s */
+		printf("%-24s %6lu requests, %8llu bytes staged, "
+		    "%.1f MB/s\n", cases[i_case].name, requests / iterations,
+		    staged_bytes / iterations,
+		    (double)read_size * iterations / elapsed);
+	}
+
+	free(dst_buf);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	io_block_dev_spec_t dev_spec;
+	io_dev_info_t *dev_info;
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	unsigned int i;
+	int c, ret = 0;
+
+	while ((c = getopt(argc, argv, "ai:B:b:m:s:r:")) != -1) {
+		switch (c) {
+		case 'a':
+			async = 1;
+			break;
+		case 'i':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 'B':
+			block_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			buf_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			max_read_size = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			read_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			request_ns = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+
+	if (argc != 0 || iterations == 0 || read_size == 0 ||
+	    !is_power_of_2(block_size) || buf_size < block_size ||
+	    (buf_size % block_size) != 0 || (max_read_size % block_size) != 0)
+		usage();
+
+	/* Leave room for the largest offset and a partial tail block */
+	disk_size = (read_size + 0x10 + 2 * block_size) & ~(block_size - 1);
+	disk = malloc(disk_size);
+	block_buf = aligned_alloc(block_size, buf_size);
+	if (disk == NULL || block_buf == NULL) {
+		fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+		exit(1);
+	}
+	for (i = 0; i < disk_size; i++)
+		disk[i] = i ^ (i >> 8) ^ (i >> 16);
+
+	memset(&dev_spec, 0, sizeof(dev_spec));
+	dev_spec.buffer.offset = (uintptr_t)block_buf;
+	dev_spec.buffer.length = buf_size;
+	dev_spec.ops.read = ram_read;
+	dev_spec.ops.write = ram_write;
+	dev_spec.ops.read_start = ram_read_start;
+	dev_spec.ops.read_wait = ram_read_wait;
+	dev_spec.block_size = block_size;
+	dev_spec.max_read_size = max_read_size;
+
+	if (block_dev_open((uintptr_t)&dev_spec, &dev_info) != 0) {
+		fprintf(stderr, "ERROR: cannot open the block device\n");
+		exit(1);
+	}
+
+	printf("Reading 0x%zx bytes, block size 0x%zx, buffer size 0x%zx\n",
+	    read_size, block_size, buf_size);
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+		ret |= bench_case(dev_info, i, iterations);
+
+	block_dev_close(dev_info);
+	free(block_buf);
+	free(disk);
+	return ret;
+}
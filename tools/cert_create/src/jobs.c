@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE		200809L
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+#include "jobs.h"
+
+/*
+ * The jobs are numbered from 0 and handed out in order to the threads, so the
+ * caller controls which jobs start first. The calling thread runs jobs too.
+ */
+static int num_threads = 1;
+static int num_jobs;
+static int next_job;
+static void (*job_fn)(int job);
+static pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Set the number of threads used to run the jobs. If 'threads' is not
+ * positive, use one thread per online CPU. Returns the number of threads.
+ */
+int jobs_init(int threads)
+{
+	long cpus;
+
+	if (threads <= 0) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? cpus : 1;
+	}
+	if (threads > JOBS_MAX_THREADS) {
+		threads = JOBS_MAX_THREADS;
+	}
+	num_threads = threads;
+
+	return num_threads;
+}
+
+static void *job_worker(void *arg)
+{
+	int job;
+
+	while (1) {
+		pthread_mutex_lock(&job_lock);
+		job = (next_job < num_jobs) ? next_job++ : -1;
+		pthread_mutex_unlock(&job_lock);
+
+		if (job < 0) {
+			break;
+		}
+		job_fn(job);
+	}
+
+	return NULL;
+}
+
+/* Run fn(0) to fn(num - 1) and wait for all of them to complete */
+void jobs_run(int num, void (*fn)(int job))
+{
+	pthread_t threads[JOBS_MAX_THREADS];
+	int i, n;
+
+	job_fn = fn;
+	num_jobs = num;
+	next_job = 0;
+
+	n = (num < num_threads) ? num : num_threads;
+	for (i = 1; i < n; i++) {
+		if (pthread_create(&threads[i], NULL, job_worker, NULL) != 0) {
+			/* Carry on with the threads already running */
+			WARN("Cannot create thread %d\n", i);
+			n = i;
+			break;
+		}
+	}
+
+	job_worker(NULL);
+
+	for (i = 1; i < n; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+/* Time in seconds, used to measure how long each phase takes */
+double jobs_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -46,6 +47,7 @@
 #include "cmd_opt.h"
 #include "debug.h"
 #include "ext.h"
+#include "jobs.h"
 #include "key.h"
 #include "platform_oid.h"
 #include "sha.h"
@@ -90,6 +92,18 @@ static int key_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int print_timing;
+static int num_threads;
+
+/*
+ * The images are hashed and the certificates created by parallel jobs. The
+ * hash of the image of extensions[i] is stored in ext_md[i].
+ */
+static unsigned char (*ext_md)[SHA256_DIGEST_LENGTH];
+static int *ext_md_valid;
+static int *hash_jobs;
+static int *cert_jobs;
+static const EVP_MD *md_info;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -256,24 +270,127 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads hashing the images and creating the "
+		"certificates (default: one per CPU)"
+	},
+	{
+		{ "print-timing", no_argument, NULL, 't' },
+		"Print the time taken by each phase in the standard output"
 	}
 };
 
-int main(int argc, char *argv[])
+static void hash_job(int job)
+{
+	int i = hash_jobs[job];
+
+	ext_md_valid[i] = sha_file(extensions[i].arg, ext_md[i]);
+}
+
+/* Sort the images by decreasing size, so that the largest start first */
+static int cmp_image_size(const void *a, const void *b)
+{
+	struct stat sa, sb;
+
+	if (stat(extensions[*(const int *)a].arg, &sa) != 0) {
+		sa.st_size = 0;
+	}
+	if (stat(extensions[*(const int *)b].arg, &sb) != 0) {
+		sb.st_size = 0;
+	}
+
+	return (sa.st_size < sb.st_size) - (sa.st_size > sb.st_size);
+}
+
+static void cert_job(int job)
 {
 	STACK_OF(X509_EXTENSION) * sk = NULL;
 	X509_EXTENSION *cert_ext = NULL;
+	cert_t *cert = &certs[cert_jobs[job]];
+	ext_t *ext = NULL;
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA256_DIGEST_LENGTH];
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg) {
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA256_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					break;
+				}
+			} else {
+				/* The hash of the file was calculated before */
+				memcpy(md, ext_md[cert->ext[j]],
+				       SHA256_DIGEST_LENGTH);
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					SHA256_DIGEST_LENGTH));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with ROT key */
+	if (!cert_new(cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext = NULL;
 	key_t *key = NULL;
 	cert_t *cert = NULL;
 	FILE *file = NULL;
-	int i, j, ext_nid, nvctr;
+	int i, num_jobs;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
 	unsigned int err_code;
-	unsigned char md[SHA256_DIGEST_LENGTH];
-	const EVP_MD *md_info;
+	double t_start, t_hash, t_key, t_sign, t_write;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -309,7 +426,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknp", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:hj:knpt", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -327,6 +444,13 @@ int main(int argc, char *argv[])
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			break;
+		case 'j':
+			num_threads = atoi(optarg);
+			if (num_threads <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -336,6 +460,9 @@ int main(int argc, char *argv[])
 		case 'p':
 			print_cert = 1;
 			break;
+		case 't':
+			print_timing = 1;
+			break;
 		case CMD_OPT_EXT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			ext = ext_get_by_opt(cur_opt);
@@ -361,10 +488,18 @@ int main(int argc, char *argv[])
 	/* Check command line arguments */
 	check_cmd_params();
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	/* Older OpenSSL versions need locking callbacks to be thread safe */
+	num_threads = 1;
+#endif
+	num_threads = jobs_init(num_threads);
+
 	/* Indicate SHA256 as image hash algorithm in the certificate
 	 * extension */
 	md_info = EVP_sha256();
 
+	t_start = jobs_time();
+
 	/* Load private keys from files (or generate new ones) */
 	for (i = 0 ; i < num_keys ; i++) {
 		/* First try to load the key from disk */
@@ -404,80 +539,57 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->arg) {
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA256_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						SHA256_DIGEST_LENGTH));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
+	t_key = jobs_time();
+
+	/* Calculate the hashes of the images, starting with the largest */
+	CHECK_NULL(ext_md, calloc(num_extensions, sizeof(*ext_md)));
+	CHECK_NULL(ext_md_valid, calloc(num_extensions, sizeof(int)));
+	CHECK_NULL(hash_jobs, calloc(num_extensions, sizeof(int)));
+	num_jobs = 0;
+	for (i = 0 ; i < num_extensions ; i++) {
+		if ((extensions[i].type == EXT_TYPE_HASH) &&
+		    (extensions[i].arg != NULL)) {
+			hash_jobs[num_jobs++] = i;
 		}
-
-		/* Create certificate. Signed with ROT key */
-		if (cert->fn && !cert_new(cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
+	}
+	qsort(hash_jobs, num_jobs, sizeof(int), cmp_image_size);
+	jobs_run(num_jobs, hash_job);
+
+	for (i = 0 ; i < num_extensions ; i++) {
+		if ((extensions[i].type == EXT_TYPE_HASH) &&
+		    (extensions[i].arg != NULL) && !ext_md_valid[i]) {
+			ERROR("Cannot calculate hash of %s\n",
+				extensions[i].arg);
 			exit(1);
 		}
-
-		sk_X509_EXTENSION_free(sk);
 	}
 
+	t_hash = jobs_time();
+
+	/*
+	 * Create the certificates. A certificate is only created once its
+	 * issuer certificate, if requested, has been created, so they are
+	 * created in rounds of independent certificates.
+	 */
+	CHECK_NULL(cert_jobs, calloc(num_certs, sizeof(int)));
+	do {
+		num_jobs = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			cert = &certs[i];
+			if ((cert->fn == NULL) || (cert->x != NULL)) {
+				continue;
+			}
+			if ((cert->issuer != i) &&
+			    (certs[cert->issuer].fn != NULL) &&
+			    (certs[cert->issuer].x == NULL)) {
+				continue;
+			}
+			cert_jobs[num_jobs++] = i;
+		}
+		jobs_run(num_jobs, cert_job);
+	} while (num_jobs > 0);
+
+	t_sign = jobs_time();
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -512,6 +624,22 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	t_write = jobs_time();
+
+	if (print_timing) {
+		printf("Time taken with %d thread(s):\n", num_threads);
+		printf("  key load: %8.3f s\n", t_key - t_start);
+		printf("  hash:     %8.3f s\n", t_hash - t_key);
+		printf("  sign:     %8.3f s\n", t_sign - t_hash);
+		printf("  write:    %8.3f s\n", t_write - t_sign);
+		printf("  total:    %8.3f s\n", t_write - t_start);
+	}
+
+	free(cert_jobs);
+	free(hash_jobs);
+	free(ext_md_valid);
+	free(ext_md);
+
 #ifndef OPENSSL_NO_ENGINE
 	ENGINE_cleanup();
 #endif
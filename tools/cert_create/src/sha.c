@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -28,37 +28,76 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define _POSIX_C_SOURCE		200809L
+
+#include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <openssl/sha.h>
 
 #include "debug.h"
 
-#define BUFFER_SIZE	256
+#define BUFFER_SIZE	(1024 * 1024)
 
+/*
+ * Calculate the SHA-256 hash of a file. Regular files are mapped into memory
+ * and hashed in one go. Other files, or files which cannot be mapped, are read
+ * through a large buffer. May be called from several threads at once.
+ */
 int sha_file(const char *filename, unsigned char *md)
 {
-	FILE *inFile;
+	int fd;
+	struct stat st;
+	void *addr;
 	SHA256_CTX shaContext;
-	int bytes;
-	unsigned char data[BUFFER_SIZE];
+	ssize_t bytes;
+	unsigned char *data;
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __FUNCTION__);
 		return 0;
 	}
 
-	inFile = fopen(filename, "rb");
-	if (inFile == NULL) {
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
 		ERROR("Cannot read %s\n", filename);
 		return 0;
 	}
 
+	if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+		addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			posix_madvise(addr, st.st_size,
+				      POSIX_MADV_SEQUENTIAL);
+			SHA256(addr, st.st_size, md);
+			munmap(addr, st.st_size);
+			close(fd);
+			return 1;
+		}
+	}
+
+	data = malloc(BUFFER_SIZE);
+	if (data == NULL) {
+		ERROR("%s(): malloc error\n", __FUNCTION__);
+		close(fd);
+		return 0;
+	}
+
 	SHA256_Init(&shaContext);
-	while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
+	while ((bytes = read(fd, data, BUFFER_SIZE)) > 0) {
 		SHA256_Update(&shaContext, data, bytes);
 	}
 	SHA256_Final(md, &shaContext);
 
-	fclose(inFile);
+	free(data);
+	close(fd);
+
+	if (bytes < 0) {
+		ERROR("Cannot read %s\n", filename);
+		return 0;
+	}
 	return 1;
 }
@@ -28,11 +28,16 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <getopt.h>
 #include <limits.h>
 #include <stdarg.h>
@@ -46,10 +51,21 @@
 
 #include "fiptool.h"
 #include "firmware_image_package.h"
+#include "lz4.h"
+#include "lz4_compress.h"
 #include "tbbr_config.h"
 
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
+#define OPT_IN_PLACE 2
+#define OPT_ALIGN 3
+#define OPT_COMPRESS 4
+
+/* copy_file_range() is only provided by glibc 2.27 onwards. */
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define HAVE_COPY_FILE_RANGE 1
+#endif
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(void);
@@ -79,6 +95,9 @@ static cmd_t cmds[] = {
 
 static image_t *images[MAX_IMAGES];
 static size_t nr_images;
+static file_map_t *file_maps;
+static char *pending_outfile;
+static char *pending_target;
 static uuid_t uuid_null = { 0 };
 static int verbose;
 
@@ -140,7 +159,8 @@ static void add_image(image_t *image)
 
 static void free_image(image_t *image)
 {
-	free(image->buffer);
+	if (image->map == NULL)
+		free(image->buffer);
 	free(image);
 }
 
@@ -177,6 +197,73 @@ static void remove_image(image_t *image)
 	nr_images--;
 }
 
+/*
+ * Map a file read-only into memory.  The images parsed from a FIP or read
+ * from an image file are views into these mappings rather than copies on
+ * the heap.  The mappings are kept until free_images() is called, after
+ * the output has been written.
+ */
+static file_map_t *map_file(char *filename)
+{
+	struct stat st;
+	file_map_t *map;
+
+	map = malloc(sizeof(*map));
+	if (map == NULL)
+		log_err("malloc");
+
+	map->fd = open(filename, O_RDONLY);
+	if (map->fd == -1)
+		log_err("open %s", filename);
+
+	if (fstat(map->fd, &st) == -1)
+		log_err("fstat %s", filename);
+
+	if ((uintmax_t)st.st_size > SIZE_MAX)
+		log_errx("%s is too large", filename);
+	map->size = st.st_size;
+	map->dev = st.st_dev;
+	map->ino = st.st_ino;
+
+	/* Zero-length mappings are not allowed. */
+	map->addr = NULL;
+	if (map->size != 0) {
+		map->addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE,
+		    map->fd, 0);
+		if (map->addr == MAP_FAILED)
+			log_err("mmap %s", filename);
+	}
+
+	map->next = file_maps;
+	file_maps = map;
+	return map;
+}
+
+/* Return 1 if the file described by 'st' is one of the mapped files. */
+static int is_mapped_file(const struct stat *st)
+{
+	file_map_t *map;
+
+	for (map = file_maps; map != NULL; map = map->next)
+		if (map->dev == st->st_dev && map->ino == st->st_ino)
+			return 1;
+	return 0;
+}
+
+static void unmap_files(void)
+{
+	file_map_t *map;
+
+	while (file_maps != NULL) {
+		map = file_maps;
+		file_maps = map->next;
+		if (map->addr != NULL)
+			munmap(map->addr, map->size);
+		close(map->fd);
+		free(map);
+	}
+}
+
 static void free_images(void)
 {
 	int i;
@@ -185,6 +272,7 @@ static void free_images(void)
 		free_image(images[i]);
 		images[i] = NULL;
 	}
+	unmap_files();
 }
 
 static toc_entry_t *lookup_entry_from_uuid(uuid_t *uuid)
@@ -210,33 +298,21 @@ static image_t *lookup_image_from_uuid(uuid_t *uuid)
 	return NULL;
 }
 
-static int parse_fip(char *filename, fip_toc_header_t *toc_header_out)
+static file_map_t *parse_fip(char *filename,
+    fip_toc_header_t *toc_header_out)
 {
-	struct stat st;
-	FILE *fp;
+	file_map_t *map;
 	char *buf, *bufend;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	image_t *image;
 	int terminated = 0;
 
-	fp = fopen(filename, "r");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
-
-	buf = malloc(st.st_size);
-	if (buf == NULL)
-		log_err("malloc");
-
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
+	map = map_file(filename);
+	buf = map->addr;
+	bufend = buf + map->size;
 
-	if (st.st_size < sizeof(fip_toc_header_t))
+	if (map->size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -267,19 +343,20 @@ static int parse_fip(char *filename, fip_toc_header_t *toc_header_out)
 
 		memcpy(&image->uuid, &toc_entry->uuid, sizeof(uuid_t));
 
-		image->buffer = malloc(toc_entry->size);
-		if (image->buffer == NULL)
-			log_err("malloc");
-
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before referencing the payload. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+		if (toc_entry->size + toc_entry->offset_address > map->size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->buffer = buf + toc_entry->offset_address;
 		image->size = toc_entry->size;
+		image->map = map;
+		image->offset = toc_entry->offset_address;
+		image->align = TOC_FLAGS_ALIGN(toc_entry->flags);
+		image->compression = TOC_FLAGS_COMPRESSION(toc_entry->flags);
+		image->compress = (toc_entry->flags & TOC_FLAGS_COMPRESS_REQ) ||
+		    image->compression != TOC_COMPRESSION_NONE;
 
 		add_image(image);
 
@@ -289,24 +366,17 @@ static int parse_fip(char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
-	return 0;
+	return map;
 }
 
 static image_t *read_image_from_file(uuid_t *uuid, char *filename)
 {
-	struct stat st;
+	file_map_t *map;
 	image_t *image;
-	FILE *fp;
 
 	assert(uuid != NULL);
 
-	fp = fopen(filename, "r");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
+	map = map_file(filename);
 
 	image = malloc(sizeof(*image));
 	if (image == NULL)
@@ -314,30 +384,143 @@ static image_t *read_image_from_file(uuid_t *uuid, char *filename)
 
 	memcpy(&image->uuid, uuid, sizeof(uuid_t));
 
-	image->buffer = malloc(st.st_size);
-	if (image->buffer == NULL)
-		log_err("malloc");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->size = st.st_size;
-
-	fclose(fp);
+	image->buffer = map->addr;
+	image->size = map->size;
+	image->map = map;
+	image->offset = 0;
+	image->align = 1;
+	image->compression = TOC_COMPRESSION_NONE;
+	image->compress = 0;
 	return image;
 }
 
-static int write_image_to_file(image_t *image, char *filename)
+static void write_buf(int fd, const void *buf, size_t len, char *filename)
 {
-	FILE *fp;
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = write(fd, buf, len);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("write %s", filename);
+		}
+		buf = (const char *)buf + ret;
+		len -= ret;
+	}
+}
 
-	fp = fopen(filename, "w");
-	if (fp == NULL)
-		log_err("fopen");
-	if (fwrite(image->buffer, 1, image->size, fp) != image->size)
-		log_errx("Failed to write %s", filename);
-	fclose(fp);
+/*
+ * Append the contents of an image to a file.  Images backed by a file are
+ * copied by the kernel where possible, so the payload is neither copied
+ * through a user space buffer nor faulted into the address space of
+ * fiptool.  Otherwise, or if the kernel refuses, fall back to write().
+ */
+static void write_image_data(int fd, image_t *image, char *filename)
+{
+	size_t done = 0;
+#ifdef __linux__
+	ssize_t ret;
+
+	if (image->map != NULL) {
+		off_t off = image->offset;
+
+#ifdef HAVE_COPY_FILE_RANGE
+		while (done < image->size) {
+			ret = copy_file_range(image->map->fd, &off, fd, NULL,
+			    image->size - done, 0);
+			if (ret <= 0)
+				break;
+			done += ret;
+		}
+#endif
+		while (done < image->size) {
+			ret = sendfile(fd, image->map->fd, &off,
+			    image->size - done);
+			if (ret <= 0)
+				break;
+			done += ret;
+		}
+	}
+#endif
+	write_buf(fd, (char *)image->buffer + done, image->size - done,
+	    filename);
+}
+
+static int write_image_to_file(image_t *image, char *filename)
+{
+	int fd;
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1)
+		log_err("open %s", filename);
+	write_image_data(fd, image, filename);
+	if (close(fd) == -1)
+		log_err("close %s", filename);
 	return 0;
 }
 
+static void remove_pending_outfile(void)
+{
+	if (pending_outfile != NULL)
+		unlink(pending_outfile);
+}
+
+/*
+ * The images may be views into the file that is about to be overwritten.
+ * In that case a new FIP is generated in a temporary file next to it and
+ * renamed into place once complete.  If 'filename' is a symbolic link,
+ * this is done next to the file it points to, so that the link is kept.
+ * The temporary file takes the permissions of the file it replaces.  Any
+ * other output, including a device node or a file that is not mapped, is
+ * simply truncated and written in place.
+ */
+static int open_outfile(char *filename)
+{
+	struct stat st;
+	int fd;
+
+	if (stat(filename, &st) == -1 || !S_ISREG(st.st_mode) ||
+	    !is_mapped_file(&st)) {
+		fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fd == -1)
+			log_err("open %s", filename);
+		return fd;
+	}
+
+	pending_target = realpath(filename, NULL);
+	if (pending_target == NULL)
+		log_err("realpath %s", filename);
+
+	pending_outfile = malloc(strlen(pending_target) + sizeof(".XXXXXX"));
+	if (pending_outfile == NULL)
+		log_err("malloc");
+	sprintf(pending_outfile, "%s.XXXXXX", pending_target);
+
+	fd = mkstemp(pending_outfile);
+	if (fd == -1)
+		log_err("mkstemp %s", pending_outfile);
+
+	if (fchmod(fd, st.st_mode & 07777) == -1)
+		log_err("fchmod %s", pending_outfile);
+	return fd;
+}
+
+static void close_outfile(int fd, char *filename)
+{
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+	if (pending_outfile == NULL)
+		return;
+
+	if (rename(pending_outfile, pending_target) == -1)
+		log_err("rename %s", pending_target);
+	free(pending_outfile);
+	pending_outfile = NULL;
+	free(pending_target);
+	pending_target = NULL;
+}
+
 static int fill_common_opts(struct option *opts, int has_arg)
 {
 	int i;
@@ -360,6 +543,100 @@ static void add_opt(struct option *opts, int idx, char *name,
 	opts[idx].val = val;
 }
 
+/*
+ * Compress the payload of an image as a single LZ4 block, preceded by the
+ * size of the image.  The image is left alone if it would not get smaller,
+ * but the request is still recorded in its ToC entry.
+ */
+static void compress_image(image_t *image, const char *name)
+{
+	fip_compressed_header_t *header;
+	size_t len;
+	char *buf;
+
+	image->compress = 1;
+	if (image->compression != TOC_COMPRESSION_NONE || image->size == 0)
+		return;
+
+	buf = malloc(sizeof(*header) + LZ4_COMPRESS_BOUND(image->size));
+	if (buf == NULL)
+		log_err("malloc");
+
+	len = lz4_compress(image->buffer, image->size,
+	    (uint8_t *)buf + sizeof(*header));
+	if (len == 0)
+		log_errx("Failed to compress %s.bin", name);
+	len += sizeof(*header);
+	if (len >= image->size) {
+		if (verbose)
+			log_dbgx("Not compressing %s.bin, it would not get "
+			    "smaller", name);
+		free(buf);
+		return;
+	}
+
+	if (verbose)
+		log_dbgx("Compressed %s.bin from 0x%llX to 0x%llX bytes", name,
+		    (unsigned long long)image->size, (unsigned long long)len);
+
+	header = (fip_compressed_header_t *)buf;
+	header->size = image->size;
+
+	if (image->map == NULL)
+		free(image->buffer);
+	image->buffer = buf;
+	image->size = len;
+	image->map = NULL;
+	image->offset = 0;
+	image->compression = TOC_COMPRESSION_LZ4;
+}
+
+/*
+ * Return a copy of an image holding its decompressed payload, or the image
+ * itself if it is not compressed.  A copy is freed with free_image().
+ */
+static image_t *decompress_image(image_t *image, char *filename)
+{
+	fip_compressed_header_t header;
+	lz4_stream_t stream;
+	image_t *copy;
+	size_t consumed;
+
+	if (image->compression == TOC_COMPRESSION_NONE)
+		return image;
+	if (image->compression != TOC_COMPRESSION_LZ4)
+		log_errx("Unknown compression %u in %s", image->compression,
+		    filename);
+
+	if (image->size < sizeof(header))
+		log_errx("FIP %s is corrupted", filename);
+	memcpy(&header, image->buffer, sizeof(header));
+	if (header.size > SIZE_MAX)
+		log_errx("FIP %s is corrupted", filename);
+
+	copy = malloc(sizeof(*copy));
+	if (copy == NULL)
+		log_err("malloc");
+	*copy = *image;
+	copy->size = header.size;
+	copy->buffer = malloc(copy->size != 0 ? copy->size : 1);
+	if (copy->buffer == NULL)
+		log_err("malloc");
+	copy->map = NULL;
+	copy->offset = 0;
+	copy->compression = TOC_COMPRESSION_NONE;
+
+	lz4_stream_init(&stream, (uintptr_t)copy->buffer);
+	if (lz4_stream_decompress(&stream,
+	    (uint8_t *)image->buffer + sizeof(header),
+	    image->size - sizeof(header),
+	    (uintptr_t)copy->buffer + copy->size, &consumed) != 0 ||
+	    consumed != image->size - sizeof(header) ||
+	    stream.out != (uint8_t *)copy->buffer + copy->size)
+		log_errx("FIP %s is corrupted", filename);
+	return copy;
+}
+
 static void md_print(unsigned char *md, size_t len)
 {
 	size_t i;
@@ -371,7 +648,6 @@ static void md_print(unsigned char *md, size_t len)
 static int info_cmd(int argc, char *argv[])
 {
 	image_t *image;
-	uint64_t image_offset;
 	uint64_t image_size = 0;
 	fip_toc_header_t toc_header;
 	int i;
@@ -391,9 +667,6 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
-	image_offset = sizeof(fip_toc_header_t) +
-	    (sizeof(fip_toc_entry_t) * (nr_images + 1));
-
 	for (i = 0; i < nr_images; i++) {
 		toc_entry_t *toc_entry;
 
@@ -405,20 +678,28 @@ static int info_cmd(int argc, char *argv[])
 			printf("Unknown entry: ");
 		image_size = image->size;
 		printf("offset=0x%llX, size=0x%llX",
-		    (unsigned long long)image_offset,
+		    (unsigned long long)image->offset,
 		    (unsigned long long)image_size);
 		if (toc_entry != NULL)
 			printf(", cmdline=\"--%s\"",
 			    toc_entry->cmdline_name);
+		if (image->compression == TOC_COMPRESSION_LZ4 &&
+		    image->size >= sizeof(fip_compressed_header_t))
+			printf(", lz4=0x%llX", (unsigned long long)
+			    ((fip_compressed_header_t *)image->buffer)->size);
 		if (verbose) {
 			unsigned char md[SHA256_DIGEST_LENGTH];
+			image_t *raw_image;
 
-			SHA256(image->buffer, image_size, md);
+			/* The hash is that of the image once decompressed. */
+			raw_image = decompress_image(image, argv[0]);
+			SHA256(raw_image->buffer, raw_image->size, md);
 			printf(", sha256=");
 			md_print(md, sizeof(md));
+			if (raw_image != image)
+				free_image(raw_image);
 		}
 		putchar('\n');
-		image_offset += image_size;
 	}
 
 	free_images();
@@ -431,28 +712,55 @@ static void info_usage(void)
 	exit(1);
 }
 
-static int pack_images(char *filename, uint64_t toc_flags)
+static unsigned int log2_align(uint64_t align)
+{
+	unsigned int shift = 0;
+
+	while ((1ULL << shift) < align)
+		shift++;
+	return shift;
+}
+
+static uint64_t align_up(uint64_t offset, uint64_t align)
+{
+	return (offset + align - 1) & ~(align - 1);
+}
+
+/*
+ * The payload of an image is aligned to the alignment requested for it or
+ * to the one recorded in the ToC header, whichever is larger.
+ */
+static uint64_t image_align(image_t *image, uint64_t toc_flags)
+{
+	uint64_t align = TOC_FLAGS_ALIGN(toc_flags);
+
+	return image->align > align ? image->align : align;
+}
+
+/* Size of the ToC for the image table, including the terminator entry. */
+static size_t toc_size(void)
+{
+	return sizeof(fip_toc_header_t) +
+	    sizeof(fip_toc_entry_t) * (nr_images + 1);
+}
+
+/*
+ * Build up the header and ToC entries from the image table.  The payload
+ * of images[i] is at offsets[i] and the terminator entry points at 'end'.
+ * The caller is responsible for freeing the buffer returned.
+ */
+static char *build_toc(uint64_t toc_flags, uint64_t *offsets, uint64_t end)
 {
-	FILE *fp;
-	image_t *image;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
+	image_t *image;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size;
 	int i;
 
-	/* Calculate total payload size and allocate scratch buffer. */
-	payload_size = 0;
-	for (i = 0; i < nr_images; i++)
-		payload_size += images[i]->size;
-
-	buf_size = sizeof(fip_toc_header_t) +
-	    sizeof(fip_toc_entry_t) * (nr_images + 1);
-	buf = calloc(1, buf_size);
+	buf = calloc(1, toc_size());
 	if (buf == NULL)
 		log_err("calloc");
 
-	/* Build up header and ToC entries from the image table. */
 	toc_header = (fip_toc_header_t *)buf;
 	toc_header->name = TOC_HEADER_NAME;
 	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
@@ -460,45 +768,290 @@ static int pack_images(char *filename, uint64_t toc_flags)
 
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
 
-	entry_offset = buf_size;
 	for (i = 0; i < nr_images; i++) {
 		image = images[i];
 		memcpy(&toc_entry->uuid, &image->uuid, sizeof(uuid_t));
-		toc_entry->offset_address = entry_offset;
+		toc_entry->offset_address = offsets[i];
 		toc_entry->size = image->size;
-		toc_entry->flags = 0;
-		entry_offset += toc_entry->size;
+		toc_entry->flags = (uint64_t)log2_align(image->align) <<
+		    TOC_FLAGS_ALIGN_SHIFT;
+		toc_entry->flags |= (uint64_t)image->compression <<
+		    TOC_FLAGS_COMPRESSION_SHIFT;
+		if (image->compress)
+			toc_entry->flags |= TOC_FLAGS_COMPRESS_REQ;
 		toc_entry++;
 	}
 
 	/* Append a null uuid entry to mark the end of ToC entries. */
 	memcpy(&toc_entry->uuid, &uuid_null, sizeof(uuid_t));
-	toc_entry->offset_address = entry_offset;
+	toc_entry->offset_address = end;
 	toc_entry->size = 0;
 	toc_entry->flags = 0;
 
+	return buf;
+}
+
+static void write_padding(int fd, uint64_t len, char *filename)
+{
+	static const char zeros[4096];
+
+	while (len > sizeof(zeros)) {
+		write_buf(fd, zeros, sizeof(zeros), filename);
+		len -= sizeof(zeros);
+	}
+	write_buf(fd, zeros, len, filename);
+}
+
+static int pack_images(char *filename, uint64_t toc_flags)
+{
+	int fd;
+	char *buf;
+	uint64_t offsets[MAX_IMAGES];
+	uint64_t entry_offset, buf_size, payload_size;
+	int i;
+
+	/*
+	 * Lay out the payloads after the ToC, back to back unless they have
+	 * to be aligned.  Any padding is filled with zeros.
+	 */
+	buf_size = toc_size();
+	entry_offset = buf_size;
+	for (i = 0; i < nr_images; i++) {
+		entry_offset = align_up(entry_offset,
+		    image_align(images[i], toc_flags));
+		offsets[i] = entry_offset;
+		entry_offset += images[i]->size;
+	}
+	payload_size = entry_offset - buf_size;
+
+	buf = build_toc(toc_flags, offsets, entry_offset);
+
 	/* Generate the FIP file. */
-	fp = fopen(filename, "w");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	fd = open_outfile(filename);
 
 	if (verbose)
 		log_dbgx("Metadata size: %zu bytes", buf_size);
 
-	if (fwrite(buf, 1, buf_size, fp) != buf_size)
-		log_errx("Failed to write image to %s", filename);
+	write_buf(fd, buf, buf_size, filename);
 	free(buf);
 
 	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
 
+	for (i = 0; i < nr_images; i++) {
+		write_padding(fd, offsets[i] -
+		    (i == 0 ? buf_size : offsets[i - 1] + images[i - 1]->size),
+		    filename);
+		write_image_data(fd, images[i], filename);
+	}
+
+	close_outfile(fd, filename);
+	return 0;
+}
+
+static int cmp_extent(const void *a, const void *b)
+{
+	const extent_t *ea = a, *eb = b;
+
+	if (ea->offset != eb->offset)
+		return ea->offset < eb->offset ? -1 : 1;
+	return 0;
+}
+
+static void add_extent(extent_t *extents, size_t *nr_extents,
+    uint64_t offset, uint64_t size)
+{
+	extents[*nr_extents].offset = offset;
+	extents[*nr_extents].size = size;
+	(*nr_extents)++;
+	qsort(extents, *nr_extents, sizeof(*extents), cmp_extent);
+}
+
+/*
+ * Find room for 'size' bytes aligned to 'align' in the file, given the
+ * sorted list of extents already in use.  The first gap large enough is
+ * used, otherwise the data goes after the last extent.
+ */
+static uint64_t find_free_extent(extent_t *extents, size_t nr_extents,
+    uint64_t size, uint64_t align)
+{
+	uint64_t cursor = 0;
+	size_t i;
+
+	for (i = 0; i < nr_extents; i++) {
+		if (extents[i].offset >= cursor &&
+		    extents[i].offset - cursor >= size)
+			return cursor;
+		if (extents[i].offset + extents[i].size > cursor)
+			cursor = align_up(extents[i].offset + extents[i].size,
+			    align);
+	}
+	return cursor;
+}
+
+/*
+ * Update the FIP mapped by 'fip_map' without regenerating it.  Payloads
+ * which did not change stay at their current offsets, while new or
+ * modified ones are placed in the first gap of the file large enough to
+ * hold them, or after the last payload.  The old ToC and every payload it
+ * points at are left untouched until the new ToC is written, so that the
+ * file still holds a valid FIP if the update is interrupted.  Payloads are
+ * written before the ToC, and only the bytes of the ToC which differ are
+ * rewritten.  The file is then truncated after the last payload.  The byte
+ * ranges written to the file are printed, so that a copy of the FIP in
+ * flash can be updated without rewriting all of it.
+ */
+static int update_fip_in_place(char *filename, file_map_t *fip_map,
+    uint64_t toc_flags)
+{
+	extent_t used[2 * MAX_IMAGES + 2], dirty[MAX_IMAGES + 1];
+	size_t nr_used = 0, nr_dirty = 0;
+	uint64_t offsets[MAX_IMAGES];
+	uint64_t end, first, last;
+	fip_toc_entry_t *old_entry;
+	image_t *image;
+	size_t buf_size;
+	char *buf, *old;
+	int fd, i;
+
+	buf_size = toc_size();
+	add_extent(used, &nr_used, 0, buf_size);
+
+	/* Reserve the old ToC and the payloads it points at. */
+	old_entry = (fip_toc_entry_t *)((fip_toc_header_t *)fip_map->addr + 1);
+	for (; memcmp(&old_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	    old_entry++)
+		if (old_entry->size != 0)
+			add_extent(used, &nr_used, old_entry->offset_address,
+			    old_entry->size);
+	add_extent(used, &nr_used, 0,
+	    (char *)(old_entry + 1) - (char *)fip_map->addr);
+
 	for (i = 0; i < nr_images; i++) {
 		image = images[i];
-		if (fwrite(image->buffer, 1, image->size, fp) != image->size)
-			log_errx("Failed to write image to %s", filename);
+		offsets[i] = UINT64_MAX;
+
+		/* An image identical to the one it replaces stays in place. */
+		if (image->map != fip_map) {
+			old_entry = (fip_toc_entry_t *)
+			    ((fip_toc_header_t *)fip_map->addr + 1);
+			for (; memcmp(&old_entry->uuid, &uuid_null,
+			    sizeof(uuid_t)) != 0; old_entry++) {
+				if (memcmp(&old_entry->uuid, &image->uuid,
+				    sizeof(uuid_t)) != 0)
+					continue;
+				if (old_entry->size == image->size &&
+				    memcmp((char *)fip_map->addr +
+				    old_entry->offset_address, image->buffer,
+				    image->size) == 0) {
+					if (image->map == NULL)
+						free(image->buffer);
+					image->buffer = (char *)fip_map->addr +
+					    old_entry->offset_address;
+					image->map = fip_map;
+					image->offset =
+					    old_entry->offset_address;
+				}
+				break;
+			}
+		}
+
+		if (image->map != fip_map || image->size == 0)
+			continue;
+
+		/*
+		 * Payloads overlapping the ToC, which grows when images are
+		 * added, or no longer suitably aligned have to move.  Their
+		 * current location stays reserved with the old ToC.
+		 */
+		if (image->offset >= buf_size &&
+		    image->offset % image_align(image, toc_flags) == 0)
+			offsets[i] = image->offset;
 	}
 
-	fclose(fp);
+	/* Place the new and moved payloads. */
+	for (i = 0; i < nr_images; i++) {
+		image = images[i];
+		if (offsets[i] != UINT64_MAX || image->size == 0)
+			continue;
+		offsets[i] = find_free_extent(used, nr_used, image->size,
+		    image_align(image, toc_flags));
+		add_extent(used, &nr_used, offsets[i], image->size);
+		add_extent(dirty, &nr_dirty, offsets[i], image->size);
+	}
+
+	/* The FIP ends after the last payload of the new ToC. */
+	end = buf_size;
+	for (i = 0; i < nr_images; i++)
+		if (offsets[i] != UINT64_MAX &&
+		    offsets[i] + images[i]->size > end)
+			end = offsets[i] + images[i]->size;
+	for (i = 0; i < nr_images; i++)
+		if (offsets[i] == UINT64_MAX)
+			offsets[i] = end;
+
+	buf = build_toc(toc_flags, offsets, end);
+
+	/* Find the bytes of the ToC which need to be rewritten. */
+	old = fip_map->addr;
+	for (first = 0; first < buf_size; first++)
+		if (first >= fip_map->size || buf[first] != old[first])
+			break;
+	for (last = buf_size; last > first; last--)
+		if (last > fip_map->size || buf[last - 1] != old[last - 1])
+			break;
+
+	fd = open(filename, O_WRONLY);
+	if (fd == -1)
+		log_err("open %s", filename);
+
+	for (i = 0; i < nr_images; i++) {
+		image = images[i];
+		if (image->size == 0 ||
+		    (image->map == fip_map && offsets[i] == image->offset))
+			continue;
+		if (verbose)
+			log_dbgx("Writing 0x%llX bytes at offset 0x%llX",
+			    (unsigned long long)image->size,
+			    (unsigned long long)offsets[i]);
+		if (lseek(fd, offsets[i], SEEK_SET) == -1)
+			log_err("lseek %s", filename);
+		write_image_data(fd, image, filename);
+	}
+
+	if (last > first) {
+		if (lseek(fd, first, SEEK_SET) == -1)
+			log_err("lseek %s", filename);
+		write_buf(fd, buf + first, last - first, filename);
+		add_extent(dirty, &nr_dirty, first, last - first);
+	}
+	free(buf);
+
+	/* Drop the payloads and free space no longer part of the FIP. */
+	if (end < fip_map->size) {
+		if (verbose)
+			log_dbgx("Truncating %s to 0x%llX bytes", filename,
+			    (unsigned long long)end);
+		if (ftruncate(fd, end) == -1)
+			log_err("ftruncate %s", filename);
+	}
+
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+
+	/* Report the ranges written, merging the adjacent ones. */
+	for (i = 0; i < nr_dirty; i++) {
+		first = dirty[i].offset;
+		last = first + dirty[i].size;
+		while (i + 1 < nr_dirty && dirty[i + 1].offset <= last) {
+			i++;
+			if (dirty[i].offset + dirty[i].size > last)
+				last = dirty[i].offset + dirty[i].size;
+		}
+		printf("offset=0x%llX, size=0x%llX\n",
+		    (unsigned long long)first,
+		    (unsigned long long)(last - first));
+	}
 	return 0;
 }
 
@@ -529,6 +1082,10 @@ static void update_fip(void)
 				log_dbgx("Replacing image %s.bin with %s",
 				    toc_entry->cmdline_name,
 				    toc_entry->action_arg);
+			new_image->align = old_image->align;
+			if (old_image->compress)
+				compress_image(new_image,
+				    toc_entry->cmdline_name);
 			replace_image(old_image, new_image);
 		} else {
 			if (verbose)
@@ -540,6 +1097,95 @@ static void update_fip(void)
 		free(toc_entry->action_arg);
 		toc_entry->action_arg = NULL;
 	}
+
+	/* Record the alignments requested for individual images. */
+	for (toc_entry = toc_entries;
+	     toc_entry->cmdline_name != NULL;
+	     toc_entry++) {
+		if (toc_entry->align == 0)
+			continue;
+
+		new_image = lookup_image_from_uuid(&toc_entry->uuid);
+		if (new_image != NULL)
+			new_image->align = toc_entry->align;
+		else
+			log_warnx("Cannot align %s.bin, it is not in the FIP",
+			    toc_entry->cmdline_name);
+	}
+
+	/* Compress the images requested. */
+	for (toc_entry = toc_entries;
+	     toc_entry->cmdline_name != NULL;
+	     toc_entry++) {
+		if (toc_entry->compress == 0)
+			continue;
+
+		new_image = lookup_image_from_uuid(&toc_entry->uuid);
+		if (new_image != NULL)
+			compress_image(new_image, toc_entry->cmdline_name);
+		else
+			log_warnx("Cannot compress %s.bin, it is not in the "
+			    "FIP", toc_entry->cmdline_name);
+	}
+}
+
+/* Parse the argument of --compress, the command line name of an image. */
+static void parse_compress(char *arg)
+{
+	toc_entry_t *toc_entry;
+
+	for (toc_entry = toc_entries;
+	     toc_entry->cmdline_name != NULL;
+	     toc_entry++)
+		if (strcmp(toc_entry->cmdline_name, arg) == 0)
+			break;
+	if (toc_entry->cmdline_name == NULL)
+		log_errx("Unknown image to compress: %s", arg);
+	toc_entry->compress = 1;
+}
+
+/*
+ * Parse the argument of --align, which is either an alignment for all the
+ * payloads, recorded in the ToC header flags, or NAME=ALIGNMENT for the
+ * payload of a single image, recorded in its ToC entry.  Return 1 if the
+ * ToC header flags were updated, 0 otherwise.
+ */
+static int parse_align(char *arg, unsigned long long *toc_flags)
+{
+	unsigned long long align;
+	toc_entry_t *toc_entry = NULL;
+	char *value, *endptr;
+
+	value = strchr(arg, '=');
+	if (value != NULL) {
+		for (toc_entry = toc_entries;
+		     toc_entry->cmdline_name != NULL;
+		     toc_entry++)
+			if (strncmp(toc_entry->cmdline_name, arg,
+			    value - arg) == 0 &&
+			    toc_entry->cmdline_name[value - arg] == '\0')
+				break;
+		if (toc_entry->cmdline_name == NULL)
+			log_errx("Unknown image in alignment: %s", arg);
+		value++;
+	} else {
+		value = arg;
+	}
+
+	errno = 0;
+	align = strtoull(value, &endptr, 0);
+	if (*endptr != '\0' || errno != 0 || align == 0 ||
+	    (align & (align - 1)) != 0 || align > (1ULL << 30))
+		log_errx("Invalid alignment: %s", arg);
+
+	if (toc_entry != NULL) {
+		toc_entry->align = align;
+		return 0;
+	}
+	*toc_flags &= ~(TOC_FLAGS_ALIGN_MASK << TOC_FLAGS_ALIGN_SHIFT);
+	*toc_flags |= (unsigned long long)log2_align(align) <<
+	    TOC_FLAGS_ALIGN_SHIFT;
+	return 1;
 }
 
 static void parse_plat_toc_flags(char *arg, unsigned long long *toc_flags)
@@ -557,7 +1203,7 @@ static void parse_plat_toc_flags(char *arg, unsigned long long *toc_flags)
 
 static int create_cmd(int argc, char *argv[])
 {
-	struct option opts[toc_entries_len + 1];
+	struct option opts[toc_entries_len + 4];
 	unsigned long long toc_flags = 0;
 	int i;
 
@@ -567,6 +1213,8 @@ static int create_cmd(int argc, char *argv[])
 	i = fill_common_opts(opts, required_argument);
 	add_opt(opts, i, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
+	add_opt(opts, ++i, "align", required_argument, OPT_ALIGN);
+	add_opt(opts, ++i, "compress", required_argument, OPT_COMPRESS);
 	add_opt(opts, ++i, NULL, 0, 0);
 
 	while (1) {
@@ -590,6 +1238,12 @@ static int create_cmd(int argc, char *argv[])
 		case OPT_PLAT_TOC_FLAGS:
 			parse_plat_toc_flags(optarg, &toc_flags);
 			break;
+		case OPT_ALIGN:
+			parse_align(optarg, &toc_flags);
+			break;
+		case OPT_COMPRESS:
+			parse_compress(optarg);
+			break;
 		default:
 			create_usage();
 		}
@@ -611,9 +1265,14 @@ static void create_usage(void)
 {
 	toc_entry_t *toc_entry = toc_entries;
 
-	printf("fiptool create [--plat-toc-flags <value>] [opts] FIP_FILENAME\n");
+	printf("fiptool create [--plat-toc-flags <value>] [--align <value>] "
+	    "[--compress <image>] [opts] FIP_FILENAME\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field "
 	    "occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --align [<image>=]<value>\tAlign the payloads, or only the "
+	    "payload of the given image, to <value> bytes.\n");
+	printf("  --compress <image>\t\tCompress the payload of the given "
+	    "image with LZ4.\n");
 	fputc('\n', stderr);
 	printf("Specific images are packed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -624,11 +1283,14 @@ static void create_usage(void)
 
 static int update_cmd(int argc, char *argv[])
 {
-	struct option opts[toc_entries_len + 2];
+	struct option opts[toc_entries_len + 6];
 	char outfile[FILENAME_MAX] = { 0 };
 	fip_toc_header_t toc_header = { 0 };
 	unsigned long long toc_flags = 0;
+	file_map_t *fip_map = NULL;
 	int pflag = 0;
+	int iflag = 0;
+	int aflag = 0;
 	int i;
 
 	if (argc < 2)
@@ -638,6 +1300,9 @@ static int update_cmd(int argc, char *argv[])
 	add_opt(opts, i, "out", required_argument, 'o');
 	add_opt(opts, ++i, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
+	add_opt(opts, ++i, "in-place", no_argument, OPT_IN_PLACE);
+	add_opt(opts, ++i, "align", required_argument, OPT_ALIGN);
+	add_opt(opts, ++i, "compress", required_argument, OPT_COMPRESS);
 	add_opt(opts, ++i, NULL, 0, 0);
 
 	while (1) {
@@ -663,6 +1328,15 @@ static int update_cmd(int argc, char *argv[])
 			pflag = 1;
 			break;
 		}
+		case OPT_IN_PLACE:
+			iflag = 1;
+			break;
+		case OPT_ALIGN:
+			aflag |= parse_align(optarg, &toc_flags);
+			break;
+		case OPT_COMPRESS:
+			parse_compress(optarg);
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -676,19 +1350,28 @@ static int update_cmd(int argc, char *argv[])
 	if (argc == 0)
 		update_usage();
 
+	if (iflag && outfile[0] != '\0')
+		log_errx("--in-place and --out cannot be used together");
+
 	if (outfile[0] == '\0')
 		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
 
-	if (access(outfile, F_OK) == 0)
-		parse_fip(argv[0], &toc_header);
+	if (iflag || access(outfile, F_OK) == 0)
+		fip_map = parse_fip(argv[0], &toc_header);
 
 	if (pflag)
 		toc_header.flags &= ~(0xffffULL << 32);
+	if (aflag)
+		toc_header.flags &= ~(TOC_FLAGS_ALIGN_MASK <<
+		    TOC_FLAGS_ALIGN_SHIFT);
 	toc_flags = (toc_header.flags |= toc_flags);
 
 	update_fip();
 
-	pack_images(outfile, toc_flags);
+	if (iflag)
+		update_fip_in_place(argv[0], fip_map, toc_flags);
+	else
+		pack_images(outfile, toc_flags);
 	free_images();
 	return 0;
 }
@@ -697,11 +1380,18 @@ static void update_usage(void)
 {
 	toc_entry_t *toc_entry = toc_entries;
 
-	printf("fiptool update [--out FIP_FILENAME] "
-	    "[--plat-toc-flags <value>] [opts] FIP_FILENAME\n");
+	printf("fiptool update [--out FIP_FILENAME | --in-place] "
+	    "[--plat-toc-flags <value>] [--align <value>] "
+	    "[--compress <image>] [opts] FIP_FILENAME\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
+	printf("  --in-place\t\t\tUpdate FIP_FILENAME in place and print the "
+	    "byte ranges written.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field "
 	    "occupying bits 32-47 in 64-bit ToC header.\n");
+	printf("  --align [<image>=]<value>\tAlign the payloads, or only the "
+	    "payload of the given image, to <value> bytes.\n");
+	printf("  --compress <image>\t\tCompress the payload of the given "
+	    "image with LZ4.\n");
 	fputc('\n', stderr);
 	printf("Specific images are packed with the following options:\n");
 	for (; toc_entry->cmdline_name != NULL; toc_entry++)
@@ -793,9 +1483,14 @@ static int unpack_cmd(int argc, char *argv[])
 		}
 
 		if (access(file, F_OK) != 0 || fflag) {
+			image_t *raw_image;
+
 			if (verbose)
 				log_dbgx("Unpacking %s", file);
-			write_image_to_file(image, file);
+			raw_image = decompress_image(image, argv[0]);
+			write_image_to_file(raw_image, file);
+			if (raw_image != image)
+				free_image(raw_image);
 		} else {
 			log_warnx("File %s already exists, use --force to overwrite it",
 			    file);
@@ -981,6 +1676,9 @@ int main(int argc, char *argv[])
 		usage();
 	argc--, argv++;
 
+	/* Do not leave a partial FIP behind if a command fails. */
+	atexit(remove_pending_outfile);
+
 	if (strcmp(argv[0], "-v") == 0 ||
 	    strcmp(argv[0], "--verbose") == 0) {
 		verbose = 1;
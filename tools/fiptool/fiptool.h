@@ -31,6 +31,8 @@
 #ifndef __FIPTOOL_H__
 #define __FIPTOOL_H__
 
+#include <sys/types.h>
+
 #include <stddef.h>
 #include <stdint.h>
 
@@ -53,12 +55,41 @@ enum {
 	LOG_ERR
 };
 
+/* A file mapped read-only into memory, and the device and inode it is. */
+typedef struct file_map {
+	int               fd;
+	void             *addr;
+	size_t            size;
+	dev_t             dev;
+	ino_t             ino;
+	struct file_map  *next;
+} file_map_t;
+
+/*
+ * When 'map' is not NULL, 'buffer' is a view into that mapping, starting
+ * 'offset' bytes into the file, and is not owned by the image.  'align' is
+ * the alignment requested for the payload in the FIP, 1 if none.
+ * 'compression' tells how 'buffer' is compressed, TOC_COMPRESSION_NONE if
+ * it holds the image as is.  'compress' is set when compression was
+ * requested for the image, whether or not it got applied.
+ */
 typedef struct image {
 	uuid_t            uuid;
 	size_t            size;
 	void             *buffer;
+	file_map_t       *map;
+	size_t            offset;
+	uint64_t          align;
+	unsigned int      compression;
+	int               compress;
 } image_t;
 
+/* A range of bytes in a file. */
+typedef struct extent {
+	uint64_t          offset;
+	uint64_t          size;
+} extent_t;
+
 typedef struct cmd {
 	char             *name;
 	int             (*handler)(int, char **);
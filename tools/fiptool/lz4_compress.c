@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4_compress.h"
+
+/*
+ * Greedy compressor producing a single LZ4 block, as decompressed by
+ * lib/lz4/lz4_decompress.c.  Matches are found through a hash table of the
+ * last position each 4-byte sequence was seen at.  The block format
+ * requires the last 5 bytes to be literals and the last match to start at
+ * least 12 bytes before the end of the input.
+ */
+#define MIN_MATCH	4
+#define LAST_LITERALS	5
+#define MF_LIMIT	12
+#define MAX_OFFSET	65535
+#define HASH_BITS	16
+
+static uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static unsigned int hash32(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static uint8_t *put_length(uint8_t *op, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = len;
+	return op;
+}
+
+static uint8_t *put_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len,
+    size_t offset, size_t match_len)
+{
+	uint8_t *token = op++;
+
+	*token = (lit_len < 15 ? lit_len : 15) << 4;
+	if (lit_len >= 15)
+		op = put_length(op, lit_len - 15);
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	/* The last sequence only has literals. */
+	if (match_len == 0)
+		return op;
+
+	*op++ = offset & 0xff;
+	*op++ = offset >> 8;
+	match_len -= MIN_MATCH;
+	*token |= match_len < 15 ? match_len : 15;
+	if (match_len >= 15)
+		op = put_length(op, match_len - 15);
+	return op;
+}
+
+/*
+ * Compress 'len' bytes from 'src' into 'dst', which must be able to hold
+ * LZ4_COMPRESS_BOUND(len) bytes.  Return the size of the block.
+ */
+size_t lz4_compress(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	size_t *table;
+	size_t anchor = 0, pos = 0, ref, match_len;
+	uint8_t *op = dst;
+	unsigned int h;
+
+	table = calloc(1 << HASH_BITS, sizeof(*table));
+	if (table == NULL)
+		return 0;
+
+	/* Positions are stored plus one, zero marks an empty slot. */
+	while (len >= MF_LIMIT && pos <= len - MF_LIMIT) {
+		h = hash32(read32(src + pos));
+		ref = table[h];
+		table[h] = pos + 1;
+
+		if (ref == 0 || pos - (ref - 1) > MAX_OFFSET ||
+		    read32(src + ref - 1) != read32(src + pos)) {
+			pos++;
+			continue;
+		}
+		ref--;
+
+		match_len = MIN_MATCH;
+		while (pos + match_len < len - LAST_LITERALS &&
+		    src[ref + match_len] == src[pos + match_len])
+			match_len++;
+
+		/* Extend the match backwards over the pending literals. */
+		while (pos > anchor && ref > 0 && src[pos - 1] == src[ref - 1]) {
+			pos--;
+			ref--;
+			match_len++;
+		}
+
+		op = put_sequence(op, src + anchor, pos - anchor, pos - ref,
+		    match_len);
+		pos += match_len;
+		anchor = pos;
+
+		/* Index a position inside the match to find repeats sooner. */
+		if (pos - 2 > ref && pos <= len - MF_LIMIT)
+			table[hash32(read32(src + pos - 2))] = pos - 1;
+	}
+
+	op = put_sequence(op, src + anchor, len - anchor, 0, 0);
+	free(table);
+	return op - dst;
+}
@@ -44,6 +44,8 @@ typedef struct toc_entry {
 	const char   *cmdline_name;
 	int           action;
 	char         *action_arg;
+	uint64_t      align;
+	int           compress;
 } toc_entry_t;
 
 extern toc_entry_t toc_entries[];
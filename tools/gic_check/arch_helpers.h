@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host replacements for the architectural helpers used by the GICv3 driver.
+ * The system registers are plain variables, so the driver runs as if in EL3.
+ */
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+#include <stdint.h>
+
+#define DEFINE_SYSREG_RW_FUNCS(_name)				\
+static uint64_t host_ ## _name;					\
+static inline uint64_t read_ ## _name(void)			\
+{								\
+	return host_ ## _name;					\
+}								\
+static inline void write_ ## _name(uint64_t v)			\
+{								\
+	host_ ## _name = v;					\
+}
+
+DEFINE_SYSREG_RW_FUNCS(id_aa64pfr0_el1)
+DEFINE_SYSREG_RW_FUNCS(mpidr)
+DEFINE_SYSREG_RW_FUNCS(scr_el3)
+DEFINE_SYSREG_RW_FUNCS(icc_sre_el1)
+DEFINE_SYSREG_RW_FUNCS(icc_sre_el2)
+DEFINE_SYSREG_RW_FUNCS(icc_sre_el3)
+DEFINE_SYSREG_RW_FUNCS(icc_pmr_el1)
+DEFINE_SYSREG_RW_FUNCS(icc_igrpen0_el1)
+DEFINE_SYSREG_RW_FUNCS(icc_igrpen1_el3)
+DEFINE_SYSREG_RW_FUNCS(icc_hppir0_el1)
+DEFINE_SYSREG_RW_FUNCS(icc_hppir1_el1)
+
+static inline void isb(void)
+{
+}
+
+#define IS_IN_EL3()	1
+
+#endif /* __ARCH_HELPERS_H__ */
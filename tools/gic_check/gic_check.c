@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host check of the GICv3 driver save and restore of the GIC state across a
+ * power down, e.g. during system suspend. The driver code used by the firmware
+ * saves the state of a Distributor and a Redistributor modelled in memory and
+ * filled with random values, then restores it into a second pair holding the
+ * reset values. The registers configuring the interrupts must match after the
+ * restore and the pending and active bits must have been set again. The
+ * routing of an SPI must be restored when it was not 0, its reset value. The
+ * check reports the share of the registers and routes which were saved.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utils.h>
+
+/* Build the driver into this program to get at its internal functions */
+#include "../../drivers/arm/gic/common/gic_common.c"
+#include "../../drivers/arm/gic/v3/gicv3_helpers.c"
+#include "../../drivers/arm/gic/v3/gicv3_main.c"
+
+#define DEFAULT_ITERATIONS	1000
+
+#define GICD_FRAME_SIZE		0x10000
+#define GICR_FRAME_SIZE		(1 << GICR_PCPUBASE_SHIFT)
+#define GIC_MAX_BLOCKS		32
+
+/*
+ * Interrupt registers, with the number of bits used per interrupt ID. The
+ * pending and active bits can be set by the hardware after the power up, so
+ * they are only checked to have been set again.
+ */
+static const struct {
+	const char *name;
+	unsigned int offset;
+	unsigned int bits;
+	int set_only;
+} regs[] = {
+	{ "IGROUPR",	GICD_IGROUPR,		1,	0 },
+	{ "IGRPMODR",	GICD_IGRPMODR,		1,	0 },
+	{ "ICFGR",	GICD_ICFGR,		2,	0 },
+	{ "NSACR",	GICD_NSACR,		2,	0 },
+	{ "IPRIORITYR",	GICD_IPRIORITYR,	8,	0 },
+	{ "ISPENDR",	GICD_ISPENDR,		1,	1 },
+	{ "ISACTIVER",	GICD_ISACTIVER,		1,	1 },
+	{ "ISENABLER",	GICD_ISENABLER,		1,	0 },
+};
+
+/* Saved and restored GIC frames */
+static uint64_t gicd[2][GICD_FRAME_SIZE / 8];
+static uint64_t gicr[2][GICR_FRAME_SIZE / 8];
+static uintptr_t rdistif_base_addrs[1];
+
+static gicv3_dist_ctx_t dist_ctx;
+static gicv3_redist_ctx_t rdist_ctx;
+
+static const unsigned int g0_interrupts[] = { MIN_SPI_ID };
+
+static unsigned long saved_regs, total_regs;
+static unsigned long saved_routes, total_routes;
+
+static void usage(void)
+{
+	printf("gic_check [-i <iterations>] [-s <seed>]\n");
+	printf("  -i <iterations>\tNumber of round trips checked "
+	    "(default %d).\n", DEFAULT_ITERATIONS);
+	printf("  -s <seed>\t\tSeed of the random GIC states (default 1).\n");
+	exit(1);
+}
+
+static uint32_t *reg32(uint64_t *frame, unsigned int offset)
+{
+	return (uint32_t *)((uintptr_t)frame + offset);
+}
+
+/* Return 0 half of the time, as most registers hold their reset value */
+static uint32_t rand32(void)
+{
+	if (rand() & 1)
+		return 0;
+
+	return ((uint32_t)rand() << 16) ^ rand();
+}
+
+/* Fill the blocks of 32 interrupt IDs of the frame at `base` */
+static void fill_blocks(uint64_t *base, unsigned int blocks, int reset)
+{
+	unsigned int i, w;
+
+	for (i = 0; i < ARRAY_SIZE(regs); i++) {
+		/* The reset value of ICFGR is IMPLEMENTATION DEFINED */
+		if (reset && regs[i].offset != GICD_ICFGR && !regs[i].set_only)
+			continue;
+
+		for (w = 0; w < blocks * regs[i].bits; w++)
+			*reg32(base, regs[i].offset + (w << 2)) = rand32();
+	}
+}
+
+static void fill_gic(unsigned int blocks, int reset)
+{
+	uint64_t *d = gicd[reset], *r = gicr[reset];
+	unsigned int id;
+
+	memset(d, 0, GICD_FRAME_SIZE);
+	memset(r, 0, GICR_FRAME_SIZE);
+
+	*reg32(d, GICD_TYPER) = blocks - 1;
+	*reg32(d, GICD_PIDR2_GICV3) = ARCH_REV_GICV3 << PIDR2_ARCH_REV_SHIFT;
+	*reg32(r, GICR_TYPER) = TYPER_LAST_BIT;
+
+	fill_blocks(d, blocks, reset);
+	fill_blocks(r + GICR_SGIBASE_OFFSET / 8, 1, reset);
+	if (reset)
+		return;
+
+	*reg32(d, GICD_CTLR) = CTLR_ARE_S_BIT | CTLR_ARE_NS_BIT |
+			       (rand() & (CTLR_ENABLE_G0_BIT |
+					  CTLR_ENABLE_G1NS_BIT |
+					  CTLR_ENABLE_G1S_BIT));
+
+	for (id = MIN_SPI_ID; id < blocks << 5 && id <= MAX_SPI_ID; id++) {
+		if (rand() & 1)
+			d[(GICD_IROUTER >> 3) + id] =
+				((uint64_t)rand32() << 32) | rand32();
+	}
+}
+
+static void init_driver(gicv3_driver_data_t *driver, unsigned int i)
+{
+	driver->gicd_base = (uintptr_t)gicd[i];
+	driver->gicr_base = (uintptr_t)gicr[i];
+	gicv3_driver_init(driver);
+}
+
+/* Check the blocks `first` to `last` of the frames at `saved` and `restored` */
+static int check_blocks(const char *frame, uint64_t *saved, uint64_t *restored,
+			unsigned int first, unsigned int last)
+{
+	unsigned int i, w;
+	uint32_t s, r;
+
+	for (i = 0; i < ARRAY_SIZE(regs); i++) {
+		for (w = first * regs[i].bits; w < last * regs[i].bits; w++) {
+			s = *reg32(saved, regs[i].offset + (w << 2));
+			r = *reg32(restored, regs[i].offset + (w << 2));
+			if (regs[i].set_only ? (s & r) == s : s == r)
+				continue;
+
+			fprintf(stderr, "ERROR: %s %s%u: 0x%08x restored as "
+				"0x%08x\n", frame, regs[i].name, w, s, r);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int check_gic(unsigned int blocks)
+{
+	unsigned int id;
+	uint64_t route;
+
+	if (*reg32(gicd[1], GICD_CTLR) != *reg32(gicd[0], GICD_CTLR)) {
+		fprintf(stderr, "ERROR: GICD_CTLR 0x%08x restored as 0x%08x\n",
+			*reg32(gicd[0], GICD_CTLR), *reg32(gicd[1], GICD_CTLR));
+		return -1;
+	}
+
+	/* The SGIs and PPIs are held by the Redistributor */
+	if (check_blocks("GICD", gicd[0], gicd[1], 1, blocks) ||
+	    check_blocks("GICR", gicr[0] + GICR_SGIBASE_OFFSET / 8,
+			 gicr[1] + GICR_SGIBASE_OFFSET / 8, 0, 1))
+		return -1;
+
+	for (id = MIN_SPI_ID; id < GIC_MAX_BLOCKS << 5; id++) {
+		route = 0;
+		if (id < blocks << 5 && id <= MAX_SPI_ID)
+			route = gicd[0][(GICD_IROUTER >> 3) + id];
+
+		if (gicd[1][(GICD_IROUTER >> 3) + id] != route) {
+			fprintf(stderr, "ERROR: GICD_IROUTER%u: 0x%016llx "
+				"restored as 0x%016llx\n", id,
+				(unsigned long long)route,
+				(unsigned long long)
+				gicd[1][(GICD_IROUTER >> 3) + id]);
+			return -1;
+		}
+
+		if (route)
+			saved_routes++;
+		if (id < blocks << 5 && id <= MAX_SPI_ID)
+			total_routes++;
+	}
+
+	for (id = 0; id < blocks - 1; id++)
+		saved_regs += __builtin_popcount(dist_ctx.spi_blocks[id].reg_map);
+	saved_regs += __builtin_popcount(rdist_ctx.ppi_sgi_block.reg_map);
+	total_regs += blocks * GICV3_INTR_BLOCK_REGS;
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	gicv3_driver_data_t driver = {
+		.g0_interrupt_num = ARRAY_SIZE(g0_interrupts),
+		.g0_interrupt_array = g0_interrupts,
+		.rdistif_num = ARRAY_SIZE(rdistif_base_addrs),
+		.rdistif_base_addrs = rdistif_base_addrs,
+	};
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	unsigned int seed = 1;
+	unsigned int i, blocks;
+	int c;
+
+	while ((c = getopt(argc, argv, "i:s:")) != -1) {
+		switch (c) {
+		case 'i':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc || iterations == 0)
+		usage();
+
+	srand(seed);
+	write_id_aa64pfr0_el1(1ULL << ID_AA64PFR0_GIC_SHIFT);
+
+	for (i = 0; i < iterations; i++) {
+		/* GICD_TYPER.ITLinesNumber covers 1 to 32 blocks of IDs */
+		blocks = 1 + rand() % GIC_MAX_BLOCKS;
+		fill_gic(blocks, 0);
+		fill_gic(blocks, 1);
+
+		init_driver(&driver, 0);
+		gicv3_distif_save(&dist_ctx);
+		gicv3_rdistif_save(0, &rdist_ctx);
+
+		init_driver(&driver, 1);
+		gicv3_distif_restore(&dist_ctx);
+		gicv3_rdistif_restore(0, &rdist_ctx);
+
+		if (check_gic(blocks)) {
+			fprintf(stderr, "ERROR: round trip %u with %u blocks of "
+				"interrupt IDs failed\n", i, blocks);
+			return 1;
+		}
+	}
+
+	printf("%u round trips ok, saved %lu/%lu registers and %lu/%lu "
+	       "routes\n", iterations, saved_regs, total_regs, saved_routes,
+	       total_routes);
+	return 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host benchmark for the LZ4 decompressor used by the FIP driver. It
+ * decompresses the compressed payloads of a FIP with the library code used by
+ * the firmware, feeding it through a buffer and producing the output in chunks
+ * of the sizes used by io_fip and load_image(), and reports the throughput
+ * both as is and per byte of decompressor code, as the code has to fit in the
+ * trusted RAM of the images loading the FIP.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "firmware_image_package.h"
+#include "lz4.h"
+
+#define DEFAULT_ITERATIONS	100
+#define DEFAULT_BUF_SIZE	0x1000
+#define DEFAULT_CHUNK_SIZE	0x10000
+
+#ifndef LZ4_DECOMPRESS_TEXT_SIZE
+# define LZ4_DECOMPRESS_TEXT_SIZE	0
+#endif
+
+static const uuid_t uuid_null;
+static size_t buf_size = DEFAULT_BUF_SIZE;
+static size_t chunk_size = DEFAULT_CHUNK_SIZE;
+
+static void usage(void)
+{
+	printf("lz4_bench [-i <iterations>] [-b <buffer size>] "
+	    "[-c <chunk size>] FIP_FILE...\n");
+	printf("  -i <iterations>\tNumber of times each payload is "
+	    "decompressed (default %d).\n", DEFAULT_ITERATIONS);
+	printf("  -b <buffer size>\tSize of the reads from the FIP "
+	    "(FIP_LZ4_BUF_SIZE, default 0x%x).\n", DEFAULT_BUF_SIZE);
+	printf("  -c <chunk size>\tSize of the reads of the image "
+	    "(PLAT_IMAGE_LOAD_CHUNK_SIZE, default 0x%x).\n",
+	    DEFAULT_CHUNK_SIZE);
+	printf("\nThe payloads are compressed with 'fiptool create "
+	    "--compress <image>'.\n");
+	exit(1);
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/*
+ * Decompress 'src_len' bytes at 'src' to 'dst' the way io_fip does: the
+ * output is requested in chunks and the input is copied into a small buffer
+ * before being handed over to the decompressor.
+ */
+static int decompress(const uint8_t *src, size_t src_len, uint8_t *dst,
+		      size_t dst_len, uint8_t *buf)
+{
+	lz4_stream_t stream;
+	size_t pos = 0, off = 0, len = 0, consumed, n;
+	uint8_t *end;
+
+	lz4_stream_init(&stream, (uintptr_t)dst);
+	while (stream.out < dst + dst_len) {
+		end = stream.out + chunk_size;
+		if (end > dst + dst_len)
+			end = dst + dst_len;
+
+		while (stream.out < end) {
+			if (off == len) {
+				n = src_len - pos;
+				if (n == 0)
+					return -1;
+				if (n > buf_size)
+					n = buf_size;
+				memcpy(buf, src + pos, n);
+				pos += n;
+				off = 0;
+				len = n;
+			}
+			if (lz4_stream_decompress(&stream, buf + off,
+			    len - off, (uintptr_t)end, &consumed) != 0)
+				return -1;
+			off += consumed;
+		}
+	}
+
+	return (pos == src_len && off == len) ? 0 : -1;
+}
+
+static int bench_fip(const char *filename, unsigned int iterations)
+{
+	const fip_toc_header_t *toc_header;
+	const fip_toc_entry_t *toc_entry;
+	fip_compressed_header_t header;
+	const uint8_t *fip, *payload;
+	uint8_t *dst, *buf;
+	double start, elapsed, mbps;
+	unsigned int i;
+	struct stat st;
+	int fd, ret = 0;
+
+	fd = open(filename, O_RDONLY);
+	if (fd == -1 || fstat(fd, &st) == -1) {
+		fprintf(stderr, "ERROR: open %s: %s\n", filename,
+		    strerror(errno));
+		exit(1);
+	}
+	fip = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (fip == MAP_FAILED) {
+		fprintf(stderr, "ERROR: mmap %s: %s\n", filename,
+		    strerror(errno));
+		exit(1);
+	}
+	close(fd);
+
+	toc_header = (const fip_toc_header_t *)fip;
+	if (st.st_size < sizeof(*toc_header) ||
+	    toc_header->name != TOC_HEADER_NAME) {
+		fprintf(stderr, "ERROR: %s is not a FIP file\n", filename);
+		exit(1);
+	}
+
+	buf = malloc(buf_size);
+	if (buf == NULL) {
+		fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	for (toc_entry = (const fip_toc_entry_t *)(toc_header + 1);
+	     (const uint8_t *)(toc_entry + 1) <= fip + st.st_size &&
+	     memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) != 0;
+	     toc_entry++) {
+		if (TOC_FLAGS_COMPRESSION(toc_entry->flags) !=
+		    TOC_COMPRESSION_LZ4)
+			continue;
+
+		if (toc_entry->offset_address > st.st_size ||
+		    toc_entry->size > st.st_size - toc_entry->offset_address ||
+		    toc_entry->size < sizeof(header)) {
+			fprintf(stderr, "ERROR: %s is corrupted\n", filename);
+			exit(1);
+		}
+		payload = fip + toc_entry->offset_address;
+		memcpy(&header, payload, sizeof(header));
+
+		dst = malloc(header.size);
+		if (dst == NULL) {
+			fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+			exit(1);
+		}
+
+		start = now_us();
+		for (i = 0; i < iterations; i++) {
+			if (decompress(payload + sizeof(header),
+			    toc_entry->size - sizeof(header), dst, header.size,
+			    buf) != 0) {
+				fprintf(stderr, "ERROR: %s: payload at 0x%llx "
+				    "is corrupted\n", filename,
+				    (unsigned long long)
+				    toc_entry->offset_address);
+				ret = 1;
+				break;
+			}
+		}
+		elapsed = now_us() - start;
+		free(dst);
+		if (i != iterations)
+			continue;
+
+		/* Bytes per us are MB/s */
+		mbps = (double)header.size * iterations / elapsed;
+		printf("%s: payload at 0x%llx, 0x%llx bytes from 0x%llx "
+		    "(%.1f%%), %.1f MB/s", filename,
+		    (unsigned long long)toc_entry->offset_address,
+		    (unsigned long long)header.size,
+		    (unsigned long long)toc_entry->size,
+		    100.0 * toc_entry->size / header.size, mbps);
+		if (LZ4_DECOMPRESS_TEXT_SIZE != 0)
+			printf(", %.3f MB/s per byte of code (%u bytes)",
+			    mbps / LZ4_DECOMPRESS_TEXT_SIZE,
+			    LZ4_DECOMPRESS_TEXT_SIZE);
+		putchar('\n');
+	}
+
+	free(buf);
+	munmap((void *)fip, st.st_size);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	int c, ret = 0;
+
+	while ((c = getopt(argc, argv, "i:b:c:")) != -1) {
+		switch (c) {
+		case 'i':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			buf_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			chunk_size = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	if (argc == 0 || iterations == 0 || buf_size == 0 || chunk_size == 0)
+		usage();
+
+	for (; argc > 0; argc--, argv++)
+		ret |= bench_fip(argv[0], iterations);
+
+	return ret;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test and benchmark for the portable SHA-256 implementation that
+ * replaces the mbed TLS one when a hash accelerator is selected, and that is
+ * used when the CPU does not provide the accelerator. The digests of the FIPS
+ * 180-4 example messages are checked, with the input split in updates of
+ * various sizes, and the throughput is reported.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the implementation into this program */
+#include "../../drivers/auth/mbedtls/mbedtls_sha256_accel.c"
+
+#define DEFAULT_ITERATIONS	100
+#define DEFAULT_SIZE		0x100000
+
+/* Update sizes the messages are split in, 0 for a single update */
+static const size_t update_sizes[] = { 0, 1, 3, 55, 63, 64, 65, 1000 };
+
+static const struct {
+	const char *msg;
+	size_t repeat;
+	int is224;
+	const char *digest;
+} vectors[] = {
+	{ "abc", 1, 0,
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1, 0,
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ "a", 1000000, 0,
+	  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+	{ "", 1, 0,
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abc", 1, 1,
+	  "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1, 1,
+	  "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525" },
+	{ "a", 1000000, 1,
+	  "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67" },
+};
+
+static void usage(void)
+{
+	printf("sha256_bench [-i <iterations>] [-s <size>]\n");
+	printf("  -i <iterations>\tNumber of times the data is hashed "
+	    "(default %d).\n", DEFAULT_ITERATIONS);
+	printf("  -s <size>\t\tSize of the data hashed (default 0x%x).\n",
+	    DEFAULT_SIZE);
+	exit(1);
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int check_vector(unsigned int i_vec, size_t update_size)
+{
+	mbedtls_sha256_context ctx;
+	unsigned char *msg, digest[32];
+	char hex[65];
+	size_t msg_len, len, off;
+	unsigned int i;
+	int ret = 0;
+
+	len = strlen(vectors[i_vec].msg);
+	msg_len = len * vectors[i_vec].repeat;
+	msg = malloc(msg_len + 1);
+	if (msg == NULL) {
+		fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+		exit(1);
+	}
+	for (off = 0; off < msg_len; off += len)
+		memcpy(msg + off, vectors[i_vec].msg, len);
+
+	if (update_size == 0)
+		update_size = msg_len;
+
+	mbedtls_sha256_init(&ctx);
+	mbedtls_sha256_starts(&ctx, vectors[i_vec].is224);
+	for (off = 0; off < msg_len; off += len) {
+		len = msg_len - off;
+		if (len > update_size)
+			len = update_size;
+		mbedtls_sha256_update(&ctx, msg + off, len);
+	}
+	mbedtls_sha256_finish(&ctx, digest);
+	mbedtls_sha256_free(&ctx);
+
+	for (i = 0; i < (vectors[i_vec].is224 ? 28 : 32); i++)
+		sprintf(hex + 2 * i, "%02x", digest[i]);
+
+	if (strcmp(hex, vectors[i_vec].digest) != 0) {
+		fprintf(stderr, "ERROR: SHA-%d of vector %u with updates of "
+		    "%zu bytes is %s, expected %s\n",
+		    vectors[i_vec].is224 ? 224 : 256, i_vec, update_size,
+		    hex, vectors[i_vec].digest);
+		ret = 1;
+	}
+
+	free(msg);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	mbedtls_sha256_context ctx;
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	size_t size = DEFAULT_SIZE;
+	unsigned char *data, digest[32];
+	double start, elapsed;
+	unsigned int i, j;
+	int c, ret = 0;
+
+	while ((c = getopt(argc, argv, "i:s:")) != -1) {
+		switch (c) {
+		case 'i':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			size = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+
+	if (argc != 0 || iterations == 0 || size == 0)
+		usage();
+
+	for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+		for (j = 0; j < sizeof(update_sizes) / sizeof(update_sizes[0]);
+		     j++)
+			ret |= check_vector(i, update_sizes[j]);
+	if (ret != 0)
+		return ret;
+	printf("Known-answer tests passed\n");
+
+	data = malloc(size);
+	if (data == NULL) {
+		fprintf(stderr, "ERROR: malloc: %s\n", strerror(errno));
+		exit(1);
+	}
+	for (i = 0; i < size; i++)
+		data[i] = i;
+
+	start = now_us();
+	for (i = 0; i < iterations; i++) {
+		mbedtls_sha256_init(&ctx);
+		mbedtls_sha256_starts(&ctx, 0);
+		mbedtls_sha256_update(&ctx, data, size);
+		mbedtls_sha256_finish(&ctx, digest);
+		mbedtls_sha256_free(&ctx);
+	}
+	elapsed = now_us() - start;
+
+	/* Bytes per us are MB/s */
+	printf("Hashed 0x%zx bytes: %.1f MB/s\n", size,
+	    (double)size * iterations / elapsed);
+
+	free(data);
+	return 0;
+}
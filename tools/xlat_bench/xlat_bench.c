@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host benchmark for the translation table library. It builds the tables for
+ * one or more memory maps with the library code used by the firmware and
+ * reports the time taken and the number of tables and regions needed, so that
+ * regressions and MAX_XLAT_TABLES overflows can be caught without running the
+ * firmware.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the library into this program to get at its internal state */
+#include "../../lib/xlat_tables/xlat_tables_common.c"
+
+#if ADDR_SPACE_SIZE > (1ull << L0_XLAT_ADDRESS_SHIFT)
+# define BASE_LEVEL		0
+#elif ADDR_SPACE_SIZE > (1ull << L1_XLAT_ADDRESS_SHIFT)
+# define BASE_LEVEL		1
+#else
+# define BASE_LEVEL		2
+#endif
+#define BASE_LEVEL_SHIFT	(L0_XLAT_ADDRESS_SHIFT - \
+					BASE_LEVEL * XLAT_TABLE_ENTRIES_SHIFT)
+#define NUM_BASE_LEVEL_ENTRIES	(ADDR_SPACE_SIZE >> BASE_LEVEL_SHIFT)
+
+#define DEFAULT_ITERATIONS	1000
+
+static uint64_t base_xlation_table[NUM_BASE_LEVEL_ENTRIES]
+		__attribute__((aligned(NUM_BASE_LEVEL_ENTRIES * sizeof(uint64_t))));
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+void xlat_arch_tlbi_va(uintptr_t va)
+{
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+}
+#endif
+
+static const struct {
+	const char *name;
+	unsigned int attr;
+} attr_names[] = {
+	{ "MT_DEVICE",		MT_DEVICE },
+	{ "MT_NON_CACHEABLE",	MT_NON_CACHEABLE },
+	{ "MT_MEMORY",		MT_MEMORY },
+	{ "MT_RO",		MT_RO },
+	{ "MT_RW",		MT_RW },
+	{ "MT_SECURE",		MT_SECURE },
+	{ "MT_NS",		MT_NS },
+	{ "MT_EXECUTE",		MT_EXECUTE },
+	{ "MT_EXECUTE_NEVER",	MT_EXECUTE_NEVER },
+};
+
+static void usage(void)
+{
+	printf("xlat_bench [-i <iterations>] [-t <max tables>] "
+	    "[-r <max regions>] MAP_FILE...\n");
+	printf("  -i <iterations>\tNumber of times the tables are built "
+	    "(default %d).\n", DEFAULT_ITERATIONS);
+	printf("  -t <max tables>\tFail if a map needs more translation "
+	    "tables (MAX_XLAT_TABLES).\n");
+	printf("  -r <max regions>\tFail if a map has more regions "
+	    "(MAX_MMAP_REGIONS).\n");
+	printf("\nEach line of a map file describes a region as:\n");
+	printf("  <PA> <VA> <size> <attributes>\n");
+	printf("where the attributes are either a number or MT_* names "
+	    "joined by '|'.\n");
+	printf("The lines printed by print_mmap() in verbose builds are "
+	    "also accepted.\n");
+	exit(1);
+}
+
+static int parse_attr(char *str, unsigned int *attr)
+{
+	char *tok, *end;
+	unsigned int i;
+
+	*attr = 0;
+	for (tok = strtok(str, "|"); tok != NULL; tok = strtok(NULL, "|")) {
+		if (tok[0] >= '0' && tok[0] <= '9') {
+			*attr |= strtoul(tok, &end, 0);
+			if (*end != '\0')
+				return -1;
+			continue;
+		}
+
+		for (i = 0; i < ARRAY_SIZE(attr_names); i++) {
+			if (strcmp(tok, attr_names[i].name) == 0)
+				break;
+		}
+		if (i == ARRAY_SIZE(attr_names))
+			return -1;
+		*attr |= attr_names[i].attr;
+	}
+
+	return 0;
+}
+
+/* Adds the regions described in 'filename' and returns how many there are */
+static unsigned int load_map(const char *filename)
+{
+	char line[256], attr_str[128];
+	unsigned long long pa, va, size;
+	unsigned int attr, nr_regions = 0, line_nr = 0;
+	FILE *fp;
+	char *p;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL) {
+		fprintf(stderr, "ERROR: fopen %s: %s\n", filename,
+		    strerror(errno));
+		exit(1);
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		line_nr++;
+		p = strchr(line, '#');
+		if (p != NULL)
+			*p = '\0';
+
+		if (sscanf(line, " VA:%llx PA:%llx size:%llx attr:%x",
+		    &va, &pa, &size, &attr) != 4) {
+			p = line + strspn(line, " \t\r\n");
+			if (*p == '\0')
+				continue;
+
+			if (sscanf(p, "%lli %lli %lli %127s", &pa, &va, &size,
+			    attr_str) != 4 || parse_attr(attr_str, &attr)) {
+				fprintf(stderr, "ERROR: %s:%u: invalid region\n",
+				    filename, line_nr);
+				exit(1);
+			}
+		}
+
+		if (nr_regions == MAX_MMAP_REGIONS) {
+			fprintf(stderr, "ERROR: %s: more than %d regions\n",
+			    filename, MAX_MMAP_REGIONS);
+			exit(1);
+		}
+		if (va + size - 1 > ADDR_SPACE_SIZE - 1) {
+			fprintf(stderr, "ERROR: %s:%u: region is outside of "
+			    "the address space\n", filename, line_nr);
+			exit(1);
+		}
+
+		mmap_add_region(pa, va, size, attr);
+		nr_regions++;
+	}
+
+	fclose(fp);
+	return nr_regions;
+}
+
+static void reset_tables(void)
+{
+	next_xlat = 0;
+#if PLAT_XLAT_TABLES_DYNAMIC
+	xlat_free_tables = NULL;
+#endif
+}
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int iterations = DEFAULT_ITERATIONS, max_tables = 0;
+	unsigned int max_regions = 0, nr_regions, i;
+	unsigned long long max_pa;
+	uintptr_t max_va;
+	double start, elapsed;
+	int c, ret = 0;
+
+	while ((c = getopt(argc, argv, "i:t:r:")) != -1) {
+		switch (c) {
+		case 'i':
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			max_tables = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			max_regions = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	if (argc == 0 || iterations == 0)
+		usage();
+
+	for (; argc > 0; argc--, argv++) {
+		memset(mmap, 0, sizeof(mmap));
+		xlat_max_pa = 0;
+		xlat_max_va = 0;
+		nr_regions = load_map(argv[0]);
+
+		start = now_us();
+		for (i = 0; i < iterations; i++) {
+			reset_tables();
+			init_xlation_table(0, base_xlation_table, BASE_LEVEL,
+			    &max_va, &max_pa);
+		}
+		elapsed = now_us() - start;
+
+		printf("%s: %u regions, %u tables, %.3f us per build\n",
+		    argv[0], nr_regions, next_xlat, elapsed / iterations);
+
+		if (max_tables != 0 && next_xlat > max_tables) {
+			fprintf(stderr, "ERROR: %s needs %u tables, more than "
+			    "the %u available\n", argv[0], next_xlat,
+			    max_tables);
+			ret = 1;
+		}
+		if (max_regions != 0 && nr_regions > max_regions) {
+			fprintf(stderr, "ERROR: %s has %u regions, more than "
+			    "the %u available\n", argv[0], nr_regions,
+			    max_regions);
+			ret = 1;
+		}
+	}
+
+	return ret;
+}